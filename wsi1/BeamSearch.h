@@ -0,0 +1,209 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef BEAMSEARCH_H
+#define BEAMSEARCH_H
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "Inversions.h"
+#include "MoveString.h"
+#include "PackedState.h"
+#include "Solution.h"
+
+
+// Beam search for a Width x Width board (up to 5x5): breadth-first, but of
+// every depth only the `beam_width` boards with the lowest estimate go on,
+// so time is O(beam_width x depth) and nothing depends on how hard the
+// instance is. All boards of a layer share g, so ordering them by h is
+// ordering them by any weighted f. The answer is not optimal - a narrow beam
+// can even lose the way entirely - and restarts rerun the search with twice
+// the width each time, cut off one move below the best path so far.
+//
+// The beam is split between the threads for expansion, each filling its own
+// list of children; the lists are joined in thread order, duplicates inside
+// the layer dropped through a flat open-addressing table, and the survivors
+// picked with nth_element on (estimate, board) - the same input always gives
+// the same path, whatever the thread count. Moving back to the parent is
+// never generated; any other way back to an earlier layer is a cycle of at
+// least 12 moves, left alone. The boards live only in the current and next
+// layer; what stays behind per layer is one 32-bit link per board (parent
+// index and move), 4 bytes x beam_width x depth for the path.
+//
+// The heuristic takes the IdaStar interface.
+template<int Width, class Heuristic>
+class BeamSearch {
+public:
+    static constexpr int cells = Width * Width;
+    static constexpr int default_max_depth = 4000;
+    typedef PackedState<Width> Packed;
+
+    // throws std::invalid_argument for a beam narrower than 1 or wider than the links can index
+    BeamSearch(const Heuristic& _heuristic, size_t _beam_width, int _threads = static_cast<int>(std::thread::hardware_concurrency()))
+            : heuristic(_heuristic), beam_width(_beam_width), threads(std::max(_threads, 1)) {
+        if (beam_width < 1 || beam_width > (UINT32_MAX >> 2)) throw std::invalid_argument("beam width out of range");
+    }
+
+    void set_restarts(int _restarts) { restarts = std::max(_restarts, 0); }
+    void set_max_depth(int _max_depth) { max_depth = _max_depth; }
+
+    // throws std::runtime_error for a permutation that cannot reach the goal,
+    // or when every beam lost the way before max_depth
+    Solution solve(const char* game_state) {
+        if (!Inversions::is_solvable(game_state, Width)) {
+            throw std::runtime_error("given starting permutation is not solvable!\n");
+        }
+        Solution solution(game_state, Width);
+        nodes_expanded = 0;
+        bool solved = false;
+        size_t width = beam_width;
+        for (int attempt = 0; attempt <= restarts; attempt++) {
+            MoveString moves;
+            int limit = solved ? static_cast<int>(solution.moves.size()) - 1 : max_depth;
+            if (limit >= 0 && search(game_state, width, limit, moves)) {
+                solution.moves = moves;
+                solved = true;
+            }
+            if (width > (UINT32_MAX >> 3)) break;
+            width *= 2;
+        }
+        solution.nodes_expanded = nodes_expanded;
+        if (!solved) throw std::runtime_error("the beam lost every path to the goal");
+        return solution;
+    }
+
+    unsigned long long get_nodes_expanded() const { return nodes_expanded; }
+
+private:
+    typedef typename Packed::type state_type;
+    typedef typename Heuristic::value_type value_type;
+    static constexpr int parallel_chunk = 512; // fewer boards per thread are expanded on the calling one
+
+    struct Entry {
+        state_type state;
+        value_type value;
+        int cost;
+        uint32_t link; // parent index << 2 | move
+    };
+
+    const Heuristic& heuristic;
+    size_t beam_width;
+    int threads;
+    int restarts = 0;
+    int max_depth = default_max_depth;
+    unsigned long long nodes_expanded = 0;
+
+    //// one search with the given width, the path into moves; false when the beam runs dry or reaches limit
+    bool search(const char* game_state, size_t width, int limit, MoveString& moves) {
+        char goal_state[cells];
+        for (int cell = 0; cell < cells; cell++) goal_state[cell] = static_cast<char>((cell + 1) % cells);
+        state_type goal = Packed::pack(goal_state);
+
+        std::vector<Entry> beam;
+        value_type value = heuristic.evaluate(game_state);
+        beam.push_back(Entry{Packed::pack(game_state), value, Heuristic::cost(value), 0});
+        if (beam[0].state == goal) return true;
+
+        std::vector<std::vector<uint32_t>> links; // links[d - 1][i]: how board i of depth d was reached
+        std::vector<std::vector<Entry>> children(static_cast<size_t>(threads));
+        std::vector<Entry> layer;
+        std::vector<uint32_t> slots, order;
+        for (int depth = 0; depth < limit && !beam.empty(); depth++) {
+            expand(beam, depth, children);
+            nodes_expanded += beam.size();
+
+            layer.clear();
+            for (auto& part : children) layer.insert(layer.end(), part.begin(), part.end());
+            for (const Entry& child : layer) {
+                if (child.state == goal) {
+                    trace(links, child.link, moves);
+                    return true;
+                }
+            }
+
+            //// duplicates: the first of a board in the joined lists stays
+            size_t capacity = 16;
+            while (capacity < layer.size() * 2) capacity *= 2;
+            slots.assign(capacity, 0);
+            order.clear();
+            typename Packed::hash hash;
+            for (uint32_t i = 0; i < layer.size(); i++) {
+                size_t slot = hash(layer[i].state) & (capacity - 1);
+                while (slots[slot] != 0 && layer[slots[slot] - 1].state != layer[i].state) slot = (slot + 1) & (capacity - 1);
+                if (slots[slot] != 0) continue;
+                slots[slot] = i + 1;
+                order.push_back(i);
+            }
+
+            auto better = [&layer](uint32_t a, uint32_t b) {
+                return layer[a].cost != layer[b].cost ? layer[a].cost < layer[b].cost : layer[a].state < layer[b].state;
+            };
+            if (order.size() > width) {
+                std::nth_element(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(width), order.end(), better);
+                order.resize(width);
+            }
+
+            beam.clear();
+            links.emplace_back();
+            links.back().reserve(order.size());
+            for (uint32_t i : order) {
+                beam.push_back(layer[i]);
+                links.back().push_back(layer[i].link);
+            }
+        }
+        return false;
+    }
+
+    // every board of the beam to its children, one contiguous share per thread
+    void expand(const std::vector<Entry>& beam, int depth, std::vector<std::vector<Entry>>& children) const {
+        size_t workers = std::min(static_cast<size_t>(threads), (beam.size() + parallel_chunk - 1) / parallel_chunk);
+        workers = std::max<size_t>(workers, 1);
+        for (auto& part : children) part.clear();
+        auto work = [&](size_t worker) {
+            size_t from = beam.size() * worker / workers, to = beam.size() * (worker + 1) / workers;
+            for (size_t i = from; i < to; i++) expand_one(beam[i], static_cast<uint32_t>(i), depth, children[worker]);
+        };
+        std::vector<std::thread> pool;
+        for (size_t i = 1; i < workers; i++) pool.emplace_back(work, i);
+        work(0);
+        for (auto& thread : pool) thread.join();
+    }
+
+    void expand_one(const Entry& parent, uint32_t index, int depth, std::vector<Entry>& out) const {
+        char board[cells];
+        Packed::unpack(parent.state, board);
+        int blank = static_cast<int>(std::find(board, board + cells, 0) - board), x = blank % Width, y = blank / Width;
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if ((depth > 0 && move == MoveString::inverse(static_cast<int>(parent.link & 3))) || (move == MoveString::up && y == 0)
+                || (move == MoveString::down && y == Width - 1) || (move == MoveString::left && x == 0)
+                || (move == MoveString::right && x == Width - 1)) continue;
+            int destination = blank + MoveString::offset(move, Width);
+            char tile = board[destination];
+            board[blank] = tile;
+            board[destination] = 0;
+            value_type value = heuristic.update(parent.value, board, tile, destination, blank, INT_MAX);
+            board[destination] = tile;
+            board[blank] = 0;
+            out.push_back(Entry{Packed::move_blank(parent.state, blank, destination), value, Heuristic::cost(value),
+                                index << 2 | static_cast<uint32_t>(move)});
+        }
+    }
+
+    // the moves down to a child of the last layer, from its link back through the layers
+    static void trace(const std::vector<std::vector<uint32_t>>& links, uint32_t link, MoveString& moves) {
+        std::vector<int> path = {static_cast<int>(link & 3)};
+        for (size_t d = links.size(); d > 0; d--) {
+            link = links[d - 1][link >> 2];
+            path.push_back(static_cast<int>(link & 3));
+        }
+        moves = MoveString();
+        for (auto move = path.rbegin(); move != path.rend(); ++move) moves.push_back(*move);
+    }
+};
+
+
+#endif //BEAMSEARCH_H
@@ -0,0 +1,197 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "BucketFile.h"
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <filesystem>
+
+
+BucketWriter::BucketWriter(const std::string& path, size_t buffer_records, bool append) {
+    file = std::fopen(path.c_str(), append ? "ab" : "wb");
+    if (file == nullptr) {
+        throw std::runtime_error("cannot open bucket file " + path + " for writing");
+    }
+    capacity = std::max<size_t>(buffer_records, 1);
+    active.reserve(capacity);
+    flushing.reserve(capacity);
+}
+
+BucketWriter::~BucketWriter() {
+    try {
+        close();
+    }
+    catch (const std::exception&) {
+        // a failed write only surfaces through an explicit close()
+    }
+}
+
+void BucketWriter::wait_for_pending() {
+    if (pending.valid()) pending.get();
+}
+
+void BucketWriter::flush_async() {
+    wait_for_pending();
+    std::swap(active, flushing);
+    active.clear();
+    if (flushing.empty()) return;
+
+    records_written += flushing.size();
+    pending = std::async(std::launch::async, [this]() {
+        if (std::fwrite(flushing.data(), sizeof(record), flushing.size(), file) != flushing.size()) {
+            write_failed = true; // read by close() only after the task is waited for
+        }
+    });
+}
+
+void BucketWriter::close() {
+    if (file == nullptr) return;
+    try {
+        flush_async();
+        wait_for_pending();
+    }
+    catch (...) {
+        std::fclose(file); // no task got started, nothing writes to the file any more
+        file = nullptr;
+        throw;
+    }
+    bool written = !write_failed && std::fflush(file) == 0;
+    written = std::fclose(file) == 0 && written;
+    file = nullptr;
+    if (!written) throw std::runtime_error("failed writing a bucket file");
+}
+
+
+BucketReader::BucketReader(const std::string& path, size_t buffer_records) {
+    capacity = std::max<size_t>(buffer_records, 1);
+    file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return; // a bucket that was never written is just empty
+    }
+    prefetch_async();
+}
+
+BucketReader::~BucketReader() {
+    if (pending.valid()) pending.wait();
+    if (file != nullptr) std::fclose(file);
+}
+
+void BucketReader::prefetch_async() {
+    prefetched.resize(capacity);
+    pending = std::async(std::launch::async, [this]() {
+        // partially written trailing record is silently dropped here
+        return std::fread(prefetched.data(), sizeof(record), capacity, file);
+    });
+}
+
+bool BucketReader::refill() {
+    if (file == nullptr || !pending.valid()) return false;
+
+    size_t count = pending.get();
+    prefetched.resize(count);
+    std::swap(current, prefetched);
+    position = 0;
+    if (count == capacity) {
+        prefetch_async();
+    }
+    return count > 0;
+}
+
+bool BucketReader::peek(record& state) {
+    if (position >= current.size() && !refill()) return false;
+    state = current[position];
+    return true;
+}
+
+bool BucketReader::next(record& state) {
+    if (!peek(state)) return false;
+    position++;
+    return true;
+}
+
+
+size_t bucket_record_count(const std::string& path) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    if (error) return 0;
+    return static_cast<size_t>(size / sizeof(BucketWriter::record));
+}
+
+void bucket_drop_torn_tail(const std::string& path) {
+    std::error_code error;
+    auto size = std::filesystem::file_size(path, error);
+    if (error) return;
+    auto whole = size - size % sizeof(BucketWriter::record);
+    if (whole != size) std::filesystem::resize_file(path, whole);
+}
+
+size_t bucket_sort_unique(const std::string& source, const std::string& destination, size_t memory_limit) {
+    memory_limit = std::max<size_t>(memory_limit, 1024);
+    const size_t io_buffer = std::min<size_t>(memory_limit / 4, 1 << 16);
+
+    //// phase 1: cut the input into sorted, duplicate free runs
+    std::vector<std::string> runs;
+    std::vector<BucketWriter::record> chunk;
+    {
+        BucketReader reader(source, io_buffer);
+        BucketWriter::record state;
+        bool input_left = true;
+        while (input_left) {
+            chunk.clear();
+            while (chunk.size() < memory_limit && (input_left = reader.next(state))) {
+                chunk.push_back(state);
+            }
+            if (chunk.empty() && !runs.empty()) break;
+
+            std::sort(chunk.begin(), chunk.end());
+            chunk.erase(std::unique(chunk.begin(), chunk.end()), chunk.end());
+
+            std::string run_path = destination + ".run" + std::to_string(runs.size());
+            BucketWriter writer(run_path, io_buffer, false);
+            for (auto s : chunk) writer.push(s);
+            writer.close();
+            runs.push_back(run_path);
+        }
+    }
+    std::vector<BucketWriter::record>().swap(chunk);
+
+    if (runs.size() == 1) {
+        std::filesystem::rename(runs.front(), destination);
+        return bucket_record_count(destination);
+    }
+
+    //// phase 2: k-way merge of the runs, dropping duplicates across runs
+    typedef std::pair<BucketWriter::record, size_t> head;
+    std::priority_queue<head, std::vector<head>, std::greater<head>> heads;
+    std::vector<std::unique_ptr<BucketReader>> readers;
+    for (size_t i = 0; i < runs.size(); i++) {
+        readers.emplace_back(new BucketReader(runs[i], io_buffer));
+        BucketWriter::record state;
+        if (readers.back()->next(state)) heads.push({state, i});
+    }
+
+    size_t written = 0;
+    {
+        BucketWriter writer(destination, io_buffer, false);
+        bool has_last = false;
+        BucketWriter::record last = 0;
+        while (!heads.empty()) {
+            head top = heads.top();
+            heads.pop();
+            if (!has_last || top.first != last) {
+                writer.push(top.first);
+                last = top.first;
+                has_last = true;
+                written++;
+            }
+            BucketWriter::record state;
+            if (readers[top.second]->next(state)) heads.push({state, top.second});
+        }
+    }
+
+    readers.clear();
+    for (auto& run : runs) std::filesystem::remove(run);
+    return written;
+}
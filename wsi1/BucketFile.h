@@ -0,0 +1,86 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef BUCKETFILE_H
+#define BUCKETFILE_H
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <future>
+#include <memory>
+
+
+// Bucket files are flat arrays of packed states. Both classes below keep two
+// buffers: one is filled / consumed by the search while the other one is
+// written / read in the background, so the disk never waits for the cpu and
+// the other way round.
+
+class BucketWriter {
+public:
+    typedef uint64_t record;
+
+    BucketWriter(const std::string& path, size_t buffer_records, bool append = true);
+    ~BucketWriter();
+    BucketWriter(const BucketWriter&) = delete;
+    BucketWriter& operator=(const BucketWriter&) = delete;
+
+    void push(record state) {
+        active.push_back(state);
+        if (active.size() >= capacity) flush_async();
+    }
+    // throws std::runtime_error when any write failed (disk full); the file is
+    // closed either way, the destructor closes it without throwing
+    void close();
+    size_t get_records_written() const { return records_written; }
+
+private:
+    std::FILE* file = nullptr;
+    size_t capacity;
+    size_t records_written = 0;
+    bool write_failed = false; // set by the background write
+    std::vector<record> active;
+    std::vector<record> flushing;
+    std::future<void> pending;
+
+    void flush_async();
+    void wait_for_pending();
+};
+
+
+class BucketReader {
+public:
+    typedef uint64_t record;
+
+    BucketReader(const std::string& path, size_t buffer_records);
+    ~BucketReader();
+    BucketReader(const BucketReader&) = delete;
+    BucketReader& operator=(const BucketReader&) = delete;
+
+    bool next(record& state);
+    bool peek(record& state);
+
+private:
+    std::FILE* file = nullptr;
+    size_t capacity;
+    size_t position = 0;
+    std::vector<record> current;
+    std::vector<record> prefetched;
+    std::future<size_t> pending;
+
+    void prefetch_async();
+    bool refill();
+};
+
+
+// helpers shared by the external search
+size_t bucket_record_count(const std::string& path);
+// cuts a half-written record off the end of a bucket (left behind by a crash)
+void bucket_drop_torn_tail(const std::string& path);
+// sorts a bucket and removes duplicates, spilling sorted runs to disk and
+// merging them whenever the bucket does not fit into memory_limit records
+size_t bucket_sort_unique(const std::string& source, const std::string& destination, size_t memory_limit);
+
+
+#endif //BUCKETFILE_H
@@ -0,0 +1,108 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "EightPuzzleTable.h"
+#include "Ranking.h"
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <filesystem>
+
+
+uint32_t EightPuzzleTable::rank(const char* game_state) {
+    return static_cast<uint32_t>(Ranking::lex_rank(game_state, tiles));
+}
+
+void EightPuzzleTable::unrank(uint32_t rank, char* game_state) {
+    Ranking::lex_unrank(rank, tiles, game_state);
+}
+
+static bool leaves_board(int blank, int move) {
+    int x = blank % EightPuzzleTable::width, y = blank / EightPuzzleTable::width;
+    return (move == MoveString::up && y == 0) || (move == MoveString::down && y == EightPuzzleTable::width - 1)
+           || (move == MoveString::left && x == 0) || (move == MoveString::right && x == EightPuzzleTable::width - 1);
+}
+
+void EightPuzzleTable::build(const std::string& path) {
+    std::vector<uint8_t> table(size, unreachable);
+    std::vector<uint32_t> queue;
+    queue.reserve(size / 2);
+
+    char board[tiles] = {1, 2, 3, 4, 5, 6, 7, 8, 0};
+    table[rank(board)] = 0;
+    queue.push_back(rank(board));
+
+    for (size_t head = 0; head < queue.size(); head++) {
+        unrank(queue[head], board);
+        uint8_t next_distance = table[queue[head]] + 1;
+        int blank = 0;
+        while (board[blank] != 0) blank++;
+
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if (leaves_board(blank, move)) continue;
+            int destination = MoveString::apply(board, width, blank, move);
+            uint32_t child = rank(board);
+            if (table[child] == unreachable) {
+                table[child] = next_distance;
+                queue.push_back(child);
+            }
+            MoveString::apply(board, width, destination, MoveString::inverse(move));
+        }
+    }
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out.write(reinterpret_cast<const char*>(table.data()), table.size())) {
+        throw std::runtime_error("cannot write the 8-puzzle table to " + path);
+    }
+}
+
+void EightPuzzleTable::open(const std::string& path) {
+    //// only a missing file is generated, anything else at the path is left alone
+    if (!std::filesystem::exists(path)) {
+        build(path);
+    }
+    std::error_code error;
+    if (std::filesystem::file_size(path, error) != size || error) {
+        throw std::runtime_error(path + " is not an 8-puzzle table");
+    }
+    file.open(path);
+    if (file.size() != size) {
+        throw std::runtime_error(path + " is not an 8-puzzle table");
+    }
+    distances = file.data();
+}
+
+int EightPuzzleTable::distance(const char* game_state) const {
+    uint8_t d = distances[rank(game_state)];
+    return d == unreachable ? -1 : d;
+}
+
+Solution EightPuzzleTable::solve(const char* game_state) const {
+    Solution solution(game_state, width);
+    int remaining = distance(game_state);
+    if (remaining < 0) {
+        throw std::runtime_error("given starting permutation is not solvable!\n");
+    }
+
+    char board[tiles];
+    std::copy(game_state, game_state + tiles, board);
+    int blank = 0;
+    while (board[blank] != 0) blank++;
+
+    while (remaining > 0) {
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if (leaves_board(blank, move)) continue;
+            int destination = MoveString::apply(board, width, blank, move);
+            if (distance(board) == remaining - 1) {
+                solution.moves.push_back(move);
+                blank = destination;
+                break;
+            }
+            MoveString::apply(board, width, destination, MoveString::inverse(move));
+        }
+        solution.nodes_expanded++;
+        remaining--;
+    }
+    return solution;
+}
@@ -0,0 +1,46 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef EIGHTPUZZLETABLE_H
+#define EIGHTPUZZLETABLE_H
+#include <string>
+#include <cstdint>
+#include "MappedFile.h"
+#include "Solution.h"
+
+
+// Exact distance to the goal of every 3x3 board, indexed by the lexicographic
+// rank (Lehmer code) of the board read as a permutation of 0..8. Only half of
+// the 9! permutations are reachable, the rest hold `unreachable`.
+// With the table an 8-puzzle is solved without search: from any board some
+// neighbour is exactly one move closer, so greedy descent walks straight home.
+class EightPuzzleTable {
+public:
+    static constexpr int width = 3;
+    static constexpr int tiles = width * width;
+    static constexpr uint32_t size = 362880; // 9!
+    static constexpr uint8_t unreachable = 0xFF;
+
+    EightPuzzleTable() = default;
+    explicit EightPuzzleTable(const std::string& path) { open(path); }
+
+    // loads the table from path, generating (and saving) it first if the file isn't there yet;
+    // throws std::runtime_error for a file of the wrong size, which is never overwritten
+    void open(const std::string& path);
+    static void build(const std::string& path); // retrograde breadth-first search from the goal
+
+    bool is_open() const { return distances != nullptr; }
+    int distance(const char* game_state) const; // -1 for unsolvable boards
+    Solution solve(const char* game_state) const; // throws std::runtime_error when unsolvable
+
+    static uint32_t rank(const char* game_state);
+    static void unrank(uint32_t rank, char* game_state);
+
+private:
+    MappedFile file;
+    const uint8_t* distances = nullptr;
+};
+
+
+#endif //EIGHTPUZZLETABLE_H
@@ -0,0 +1,191 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "EndgameTable.h"
+#include <cstring>
+#include <cstdio>
+#include <filesystem>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+static const char endgame_magic[4] = {'W', 'S', 'I', 'E'};
+static const size_t endgame_header_size = 32;
+
+
+// growable version of the table, only used while building
+class EndgameBuilder {
+public:
+    typedef EndgameTable::packed_state packed_state;
+
+    std::vector<packed_state> keys = std::vector<packed_state>(1024, 0);
+    std::vector<uint8_t> distances = std::vector<uint8_t>(1024, 0);
+    uint64_t count = 0;
+
+    bool contains(packed_state state) const {
+        uint64_t mask = keys.size() - 1;
+        for (uint64_t slot = EndgameTable::slot_of(state, keys.size()); keys[slot] != 0; slot = (slot + 1) & mask) {
+            if (keys[slot] == state) return true;
+        }
+        return false;
+    }
+
+    void insert(packed_state state, uint8_t distance) {
+        if (2 * (count + 1) > keys.size()) grow();
+        place(keys, distances, state, distance);
+        count++;
+    }
+
+private:
+    static void place(std::vector<packed_state>& k, std::vector<uint8_t>& d, packed_state state, uint8_t distance) {
+        uint64_t mask = k.size() - 1;
+        uint64_t slot = EndgameTable::slot_of(state, k.size());
+        while (k[slot] != 0) slot = (slot + 1) & mask;
+        k[slot] = state;
+        d[slot] = distance;
+    }
+
+    void grow() {
+        std::vector<packed_state> new_keys(keys.size() * 2, 0);
+        std::vector<uint8_t> new_distances(keys.size() * 2, 0);
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i] != 0) place(new_keys, new_distances, keys[i], distances[i]);
+        }
+        keys.swap(new_keys);
+        distances.swap(new_distances);
+    }
+};
+
+
+void EndgameTable::build(const std::string& path, int radius, unsigned threads) {
+    if (radius < 0 || radius > 255) {
+        throw std::invalid_argument("endgame radius has to fit into a byte");
+    }
+    threads = std::max(threads, 1u);
+
+    char* target = Solver::Node::generate_target();
+    packed_state goal = Packed::pack(target);
+    delete[] target;
+
+    EndgameBuilder table;
+    table.insert(goal, 0);
+    std::vector<packed_state> layer{goal};
+
+    for (int depth = 0; depth < radius && !layer.empty(); depth++) {
+        //// expand the layer - every worker takes its own slice
+        std::vector<std::vector<packed_state>> children(threads);
+        std::vector<std::thread> workers;
+        size_t slice = (layer.size() + threads - 1) / threads;
+        for (unsigned t = 0; t < threads; t++) {
+            workers.emplace_back([&, t]() {
+                size_t begin = std::min(layer.size(), t * slice), end = std::min(layer.size(), begin + slice);
+                for (size_t i = begin; i < end; i++) {
+                    int blank = Packed::find_blank(layer[i]);
+                    for (int direction : Solver::Node::all_directions) {
+                        if (!Solver::is_valid_move(blank, blank + direction)) continue;
+                        packed_state child = Packed::move_blank(layer[i], blank, blank + direction);
+                        if (!table.contains(child)) children[t].push_back(child); // read only, table is not modified here
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) worker.join();
+
+        //// merge - sorting the union makes duplicates between workers adjacent
+        layer.clear();
+        for (auto& part : children) {
+            layer.insert(layer.end(), part.begin(), part.end());
+            std::vector<packed_state>().swap(part);
+        }
+        std::sort(layer.begin(), layer.end());
+        layer.erase(std::unique(layer.begin(), layer.end()), layer.end());
+        for (auto state : layer) table.insert(state, static_cast<uint8_t>(depth + 1));
+    }
+
+    //// write - size the file table for a load factor of at most 1/2
+    uint64_t file_capacity = 1024;
+    while (file_capacity < 2 * table.count) file_capacity *= 2;
+    std::vector<packed_state> keys(file_capacity, 0);
+    std::vector<uint8_t> distances(file_capacity, 0);
+    for (size_t i = 0; i < table.keys.size(); i++) {
+        if (table.keys[i] == 0) continue;
+        uint64_t slot = slot_of(table.keys[i], file_capacity);
+        while (keys[slot] != 0) slot = (slot + 1) & (file_capacity - 1);
+        keys[slot] = table.keys[i];
+        distances[slot] = table.distances[i];
+    }
+
+    std::string temporary = path + ".tmp";
+    std::FILE* out = std::fopen(temporary.c_str(), "wb");
+    if (out == nullptr) {
+        throw std::runtime_error("cannot write endgame table " + path);
+    }
+    unsigned char header[endgame_header_size] = {};
+    uint32_t width = Solver::Node::grid_size, stored_radius = static_cast<uint32_t>(radius);
+    std::memcpy(header, endgame_magic, 4);
+    std::memcpy(header + 4, &width, 4);
+    std::memcpy(header + 8, &stored_radius, 4);
+    std::memcpy(header + 16, &file_capacity, 8);
+    std::memcpy(header + 24, &table.count, 8);
+    std::fwrite(header, 1, endgame_header_size, out);
+    std::fwrite(keys.data(), sizeof(packed_state), keys.size(), out);
+    std::fwrite(distances.data(), 1, distances.size(), out);
+    bool written = std::ferror(out) == 0;
+    if (std::fclose(out) != 0) written = false;
+    if (!written) {
+        std::filesystem::remove(temporary);
+        throw std::runtime_error("cannot write endgame table " + path);
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+void EndgameTable::load(const std::string& path) {
+    file.open(path);
+    const unsigned char* data = file.data();
+    uint32_t width = 0, stored_radius = 0;
+    if (file.size() < endgame_header_size || std::memcmp(data, endgame_magic, 4) != 0) {
+        throw std::runtime_error(path + " is not an endgame table");
+    }
+    std::memcpy(&width, data + 4, 4);
+    std::memcpy(&stored_radius, data + 8, 4);
+    std::memcpy(&capacity, data + 16, 8);
+    std::memcpy(&count, data + 24, 8);
+    if (width != Solver::Node::grid_size || file.size() != endgame_header_size + capacity * (sizeof(packed_state) + 1)) {
+        throw std::runtime_error(path + " does not match this board size");
+    }
+    radius = static_cast<int>(stored_radius);
+    keys = reinterpret_cast<const packed_state*>(data + endgame_header_size);
+    distances = data + endgame_header_size + capacity * sizeof(packed_state);
+}
+
+int EndgameTable::distance(packed_state state) const {
+    if (keys == nullptr) return -1;
+    for (uint64_t slot = slot_of(state, capacity); keys[slot] != 0; slot = (slot + 1) & (capacity - 1)) {
+        if (keys[slot] == state) return distances[slot];
+    }
+    return -1;
+}
+
+MoveString EndgameTable::finish(packed_state state) const {
+    MoveString moves;
+    int remaining = distance(state);
+    if (remaining < 0) {
+        throw std::invalid_argument("state is outside of the endgame table");
+    }
+    while (remaining > 0) {
+        int blank = Packed::find_blank(state);
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            int destination = blank + MoveString::offset(move, Solver::Node::grid_size);
+            if (!Solver::is_valid_move(blank, destination)) continue;
+            packed_state next = Packed::move_blank(state, blank, destination);
+            if (distance(next) == remaining - 1) {
+                moves.push_back(move);
+                state = next;
+                break;
+            }
+        }
+        remaining--;
+    }
+    return moves;
+}
@@ -0,0 +1,60 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef ENDGAMETABLE_H
+#define ENDGAMETABLE_H
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "Solver.h"
+#include "PackedState.h"
+#include "MappedFile.h"
+#include "MoveString.h"
+
+
+// Every state within `radius` moves of Node::generate_target() together with
+// its exact distance, kept in an open addressing hash set (linear probing,
+// packed state 0 marks an empty slot - no board packs to 0).
+//
+// file layout, loaded through MappedFile without copying:
+//   header (32 bytes): "WSIE", u32 width, u32 radius, u32 unused, u64 capacity, u64 count
+//   u64 keys[capacity]
+//   u8 distances[capacity]
+class EndgameTable {
+public:
+    typedef PackedState<Solver::Node::grid_size> Packed;
+    typedef Packed::type packed_state;
+
+    EndgameTable() = default;
+    explicit EndgameTable(const std::string& path) { load(path); }
+
+    // breadth-first search from the goal, each layer expanded by `threads` workers
+    static void build(const std::string& path, int radius, unsigned threads = std::thread::hardware_concurrency());
+    void load(const std::string& path);
+
+    int distance(packed_state state) const; // -1 when the state lies outside the radius
+    int get_radius() const { return radius; }
+    size_t size() const { return count; }
+
+    // moves from state (which has to be inside the table) straight to the goal
+    MoveString finish(packed_state state) const;
+
+    static uint64_t slot_of(packed_state state, uint64_t capacity) {
+        state ^= state >> 33;
+        state *= 0xff51afd7ed558ccdULL;
+        state ^= state >> 33;
+        return state & (capacity - 1);
+    }
+
+private:
+    MappedFile file;
+    const packed_state* keys = nullptr;
+    const uint8_t* distances = nullptr;
+    uint64_t capacity = 0;
+    uint64_t count = 0;
+    int radius = -1;
+};
+
+
+#endif //ENDGAMETABLE_H
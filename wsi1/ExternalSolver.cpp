@@ -0,0 +1,277 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "ExternalSolver.h"
+#include "BucketFile.h"
+#include "HeuristicRegistry.h"
+#include "Inversions.h"
+#include <filesystem>
+#include <sstream>
+#include <memory>
+#include <regex>
+
+namespace fs = std::filesystem;
+
+
+ExternalSolver::ExternalSolver(char* _init_state, std::string bucket_directory, std::string _heuristic, size_t _memory_limit) {
+    init_state = _init_state;
+    directory = std::move(bucket_directory);
+    heuristic = std::move(_heuristic);
+    memory_limit = std::max<size_t>(_memory_limit, 1024);
+    io_buffer = std::min<size_t>(memory_limit / 8, 1 << 16);
+
+    start = Packed::pack(init_state);
+    char* target = Solver::Node::generate_target();
+    goal = Packed::pack(target);
+    delete[] target;
+}
+
+std::string ExternalSolver::open_path(const bucket& b) const {
+    return directory + "/open_g" + std::to_string(b.first) + "_h" + std::to_string(b.second) + ".bkt";
+}
+
+std::string ExternalSolver::closed_path(const bucket& b) const {
+    return directory + "/closed_g" + std::to_string(b.first) + "_h" + std::to_string(b.second) + ".bkt";
+}
+
+bool ExternalSolver::load_start_state(const std::string& bucket_directory, char* game_state) {
+    std::ifstream meta(bucket_directory + "/search.meta");
+    std::string key;
+    int grid_size = 0;
+    packed_state packed = 0;
+    if (!(meta >> key >> grid_size >> key >> std::hex >> packed) || grid_size != Solver::Node::grid_size) {
+        return false;
+    }
+    Packed::unpack(packed, game_state);
+    return true;
+}
+
+void ExternalSolver::resume_or_start(int start_cost) {
+    fs::create_directories(directory);
+    open_buckets.clear();
+    closed_buckets.clear();
+
+    //// the meta file pins the directory to a single start permutation
+    std::string meta_path = directory + "/search.meta";
+    if (!fs::exists(meta_path) && !fs::is_empty(directory)) {
+        throw std::runtime_error("bucket directory " + directory + " is not empty and holds no search!");
+    }
+    std::ostringstream expected;
+    expected << "grid_size " << Solver::Node::grid_size << "\nstart " << std::hex << start << "\nheuristic " << heuristic << "\n";
+    if (fs::exists(meta_path)) {
+        std::ifstream meta(meta_path);
+        std::stringstream found;
+        found << meta.rdbuf();
+        if (found.str() != expected.str()) {
+            throw std::runtime_error("bucket directory " + directory + " belongs to a different search!");
+        }
+    } else {
+        std::ofstream meta(meta_path);
+        meta << expected.str();
+    }
+
+    //// pick up whatever a previous (possibly crashed) run left behind; of the rest only
+    //// the temporaries expand_bucket() and bucket_sort_unique() write get removed
+    static const std::regex temporary(R"((open|closed)_g\d+_h\d+\.bkt\.(sorted|fresh|tmp|sorted\.run\d+))");
+    for (const auto& entry : fs::directory_iterator(directory)) {
+        std::string name = entry.path().filename().string();
+        bool bucket_file = entry.path().extension() == ".bkt";
+        int g, h;
+        if (bucket_file && std::sscanf(name.c_str(), "open_g%d_h%d.bkt", &g, &h) == 2) {
+            bucket_drop_torn_tail(entry.path().string());
+            open_buckets.insert({g, h});
+        } else if (bucket_file && std::sscanf(name.c_str(), "closed_g%d_h%d.bkt", &g, &h) == 2) {
+            closed_buckets.insert({g, h});
+        } else if (entry.is_regular_file() && std::regex_match(name, temporary)) {
+            fs::remove(entry.path());
+        }
+    }
+
+    if (open_buckets.empty() && closed_buckets.empty()) {
+        bucket first{0, start_cost};
+        BucketWriter writer(open_path(first), 1, false);
+        writer.push(start);
+        writer.close();
+        open_buckets.insert(first);
+    }
+}
+
+Solution ExternalSolver::solve() {
+    if (!Inversions::is_solvable(init_state, Solver::Node::grid_size)) {
+        throw std::runtime_error("given starting permutation is not solvable!\n");
+    }
+    return HeuristicRegistry::dispatch<Solver::Node::grid_size>(heuristic, [this](const auto& estimator) {
+        return search(estimator);
+    });
+}
+
+template<class Heuristic>
+Solution ExternalSolver::search(const Heuristic& estimator) {
+    if (!Heuristic::is_admissible) {
+        throw std::invalid_argument("the external search needs an admissible heuristic, " + heuristic + " is not");
+    }
+    resume_or_start(Heuristic::cost(estimator.evaluate(init_state)));
+
+    //// the goal may already sit in a closed bucket if we crashed right after finding it
+    for (const auto& b : closed_buckets) {
+        if (b.second != 0) continue;
+        BucketReader reader(closed_path(b), io_buffer);
+        packed_state state;
+        while (reader.next(state)) {
+            if (state == goal) return reconstruct_path(b.first);
+        }
+    }
+
+    while (!open_buckets.empty()) {
+        bucket current = *open_buckets.begin();
+        open_buckets.erase(open_buckets.begin());
+
+        if (expand_bucket(current, estimator)) {
+            return reconstruct_path(current.first);
+        }
+    }
+    throw std::runtime_error("external search exhausted all buckets without reaching the goal");
+}
+
+size_t ExternalSolver::subtract_closed(const std::string& sorted_open, const bucket& b, const std::string& destination) {
+    std::vector<std::unique_ptr<BucketReader>> closed;
+    for (int back = 0; back <= 2; back++) {
+        bucket previous{b.first - back, b.second};
+        if (previous.first >= 0 && closed_buckets.count(previous)) {
+            closed.emplace_back(new BucketReader(closed_path(previous), io_buffer));
+        }
+    }
+
+    BucketReader candidates(sorted_open, io_buffer);
+    BucketWriter fresh(destination, io_buffer, false);
+    packed_state state;
+    while (candidates.next(state)) {
+        bool duplicate = false;
+        for (auto& reader : closed) {
+            packed_state other;
+            while (reader->peek(other) && other < state) reader->next(other);
+            if (reader->peek(other) && other == state) {
+                duplicate = true;
+                break;
+            }
+        }
+        if (!duplicate) fresh.push(state);
+    }
+    fresh.close();
+    return fresh.get_records_written();
+}
+
+void ExternalSolver::merge_into_closed(const std::string& fresh, const bucket& b) {
+    std::string target = closed_path(b);
+    std::string merged = target + ".tmp";
+    {
+        BucketReader old_states(target, io_buffer);
+        BucketReader new_states(fresh, io_buffer);
+        BucketWriter writer(merged, io_buffer, false);
+        packed_state a, c;
+        bool has_a = old_states.next(a), has_c = new_states.next(c);
+        while (has_a || has_c) {
+            if (!has_c || (has_a && a < c)) {
+                writer.push(a);
+                has_a = old_states.next(a);
+            } else {
+                writer.push(c);
+                has_c = new_states.next(c);
+            }
+        }
+    }
+    fs::rename(merged, target);
+    closed_buckets.insert(b);
+}
+
+template<class Heuristic>
+bool ExternalSolver::expand_bucket(const bucket& b, const Heuristic& estimator) {
+    std::string sorted = open_path(b) + ".sorted";
+    std::string fresh = open_path(b) + ".fresh";
+
+    //// delayed duplicate detection
+    bucket_sort_unique(open_path(b), sorted, memory_limit);
+    size_t fresh_count = subtract_closed(sorted, b, fresh);
+    fs::remove(sorted);
+
+    //// expansion - the same successor generator as Solver::find_feasible_solution
+    bool goal_reached = false;
+    if (fresh_count > 0) {
+        std::map<int, std::unique_ptr<BucketWriter>> successors;
+        BucketReader reader(fresh, io_buffer);
+        char board[Packed::tiles];
+        packed_state state;
+        while (reader.next(state)) {
+            nodes_expanded++;
+            if (state == goal) {
+                goal_reached = true;
+                break;
+            }
+            Packed::unpack(state, board);
+            int current = Solver::find_current_blank_space_index(board);
+            for (int direction : Solver::Node::all_directions) {
+                int destination = current + direction;
+                if (!Solver::is_valid_move(current, destination)) {
+                    continue;
+                }
+                Solver::do_move(board, direction, current);
+                int h = Heuristic::cost(estimator.evaluate(board));
+                Solver::do_move(board, -direction, destination);
+
+                auto& writer = successors[h];
+                if (!writer) {
+                    writer.reset(new BucketWriter(open_path({b.first + 1, h}), io_buffer));
+                }
+                writer->push(Packed::move_blank(state, current, destination));
+            }
+        }
+        for (auto& entry : successors) {
+            entry.second->close();
+            open_buckets.insert({b.first + 1, entry.first});
+        }
+    }
+
+    //// only now the bucket counts as expanded - a crash before this point just repeats it
+    merge_into_closed(fresh, b);
+    fs::remove(fresh);
+    fs::remove(open_path(b));
+    return goal_reached;
+}
+
+Solution ExternalSolver::reconstruct_path(int goal_depth) const {
+    // walk back layer by layer: any closed state one step shallower that is
+    // adjacent to the current one is a valid predecessor
+    Solution solution(init_state, Solver::Node::grid_size);
+    solution.nodes_expanded = nodes_expanded;
+    packed_state current = goal;
+    for (int depth = goal_depth - 1; depth >= 0; depth--) {
+        int blank = Packed::find_blank(current);
+        std::vector<packed_state> neighbours;
+        for (int direction : Solver::Node::all_directions) {
+            if (Solver::is_valid_move(blank, blank + direction))
+                neighbours.push_back(Packed::move_blank(current, blank, blank + direction));
+        }
+
+        bool found = false;
+        for (const auto& b : closed_buckets) {
+            if (b.first != depth) continue;
+            BucketReader reader(closed_path(b), io_buffer);
+            packed_state state;
+            while (!found && reader.next(state)) {
+                found = std::find(neighbours.begin(), neighbours.end(), state) != neighbours.end();
+            }
+            if (found) {
+                current = state;
+                break;
+            }
+        }
+        if (!found) {
+            throw std::runtime_error("bucket files are incomplete, cannot rebuild the path");
+        }
+        // the blank went from its place in the predecessor to its place in current
+        solution.moves.push_back(MoveString::from_offset(blank - Packed::find_blank(current), Solver::Node::grid_size));
+    }
+    solution.moves.reverse();
+    return solution;
+}
@@ -0,0 +1,82 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef EXTERNALSOLVER_H
+#define EXTERNALSOLVER_H
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include "Solver.h"
+#include "PackedState.h"
+
+
+// External-memory A*: the frontier lives on disk in (g, h) buckets of packed
+// states instead of in the open/visited containers of Solver.
+//
+// Every bucket has two files in bucket_directory:
+//   open_g<g>_h<h>.bkt   - states appended by expansions, unsorted, may hold duplicates
+//   closed_g<g>_h<h>.bkt - states already expanded, sorted, unique
+// Duplicates are detected late, in one sequential pass per bucket: the open
+// file is sorted, then merged against the closed files of (g, h), (g-1, h) and
+// (g-2, h) - in an undirected graph with unit costs a state can't reappear
+// any further away than that.
+// The estimate is any admissible heuristic of the registry; with it the
+// first goal popped is at its shortest distance, and a state first expanded
+// too deep is expanded again from its shallower bucket, outside the window.
+// The directory alone describes the search, so a crashed run is resumed just
+// by constructing the solver on the same directory again. A directory that
+// is neither empty nor holds a search.meta is refused, and of its files only
+// the solver's own temporaries ever get removed.
+class ExternalSolver {
+public:
+    typedef PackedState<Solver::Node::grid_size> Packed;
+    typedef Packed::type packed_state;
+
+    static constexpr const char* default_heuristic = "walking_distance";
+
+    // the heuristic is a HeuristicRegistry spec, resolved when solve() runs
+    ExternalSolver(char* init_state, std::string bucket_directory, std::string heuristic = default_heuristic,
+                   size_t memory_limit = 1 << 22);
+    // throws std::runtime_error for an unsolvable permutation or a directory of another
+    // search, std::invalid_argument for an inadmissible heuristic
+    Solution solve();
+    // reads the start permutation of a search left in bucket_directory, false if there is none
+    static bool load_start_state(const std::string& bucket_directory, char* game_state);
+    unsigned long long get_nodes_expanded() const { return nodes_expanded; }
+
+private:
+    typedef std::pair<int, int> bucket; // (g, h)
+    struct by_f_then_g {
+        bool operator()(const bucket& a, const bucket& b) const {
+            int fa = a.first + a.second, fb = b.first + b.second;
+            return fa != fb ? fa < fb : a.first < b.first;
+        }
+    };
+
+    char* init_state;
+    packed_state start;
+    packed_state goal;
+    std::string directory;
+    std::string heuristic;
+    size_t memory_limit;
+    size_t io_buffer;
+    unsigned long long nodes_expanded = 0;
+    std::set<bucket, by_f_then_g> open_buckets;
+    std::set<bucket> closed_buckets;
+
+    std::string open_path(const bucket& b) const;
+    std::string closed_path(const bucket& b) const;
+    template<class Heuristic>
+    Solution search(const Heuristic& estimator);
+    void resume_or_start(int start_cost);
+    template<class Heuristic>
+    bool expand_bucket(const bucket& b, const Heuristic& estimator); // true once the goal got popped
+    size_t subtract_closed(const std::string& sorted_open, const bucket& b, const std::string& destination);
+    void merge_into_closed(const std::string& fresh, const bucket& b);
+    Solution reconstruct_path(int goal_depth) const;
+};
+
+
+#endif //EXTERNALSOLVER_H
@@ -0,0 +1,85 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef HEURISTICREGISTRY_H
+#define HEURISTICREGISTRY_H
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Heuristics.h"
+#include "LegacyHeuristics.h"
+#include "MaxHeuristic.h"
+#include "PatternDatabase.h"
+#include "PatternHeuristic.h"
+
+
+struct HeuristicInfo {
+    std::string name;
+    bool is_admissible;
+    bool is_consistent;
+    std::string description;
+};
+
+// Heuristics by name, for the command line and the Solver constructor.
+//
+// dispatch() picks the heuristic once and hands it to a generic callable, so
+// the search the callable runs is compiled separately for every heuristic and
+// no node pays for an indirect call:
+//   HeuristicRegistry::dispatch<4>("walking_distance", [&](const auto& h) { return IdaStar<4, std::decay_t<decltype(h)>>(h).solve(board); });
+// Specs are a name from list(), "pdb:FILE" for a pattern database,
+// "pdb_reflected:FILE" for one over the board and its mirror, or a
+// comma separated list (optionally prefixed "max:") for MaxHeuristic.
+class HeuristicRegistry {
+public:
+    static std::vector<HeuristicInfo> list() {
+        return {
+                info<Manhattan<4>>("sum of the tiles' Manhattan distances"),
+                info<LinearConflict<4>>("Manhattan plus 2 per tile leaving a line to untangle it"),
+                info<WalkingDistance<4>>("exact row and column walking distances, table built at first use"),
+                info<LegacyManhattan<4>>("half the Manhattan distance (the original Solver manhattan)"),
+                info<LegacyLinearConflict<4>>("the original Solver linear conflict"),
+                info<LegacyWalkingDistance<4>>("the original Solver walking distance mock, the Solver default"),
+                info<InversionDistance<4>>("inversions over width - 1"),
+                info<PatternHeuristic>("pdb:FILE - additive pattern database (exact or min-compressed)"),
+                info<ModuloPatternHeuristic>("pdb:FILE - modulo-3 pattern database, picked from the file"),
+                info<ReflectedPatternHeuristic>("pdb_reflected:FILE - pattern database over the board and its mirror, the larger sum"),
+                info<MaxHeuristic<4>>("a,b,pdb_reflected:FILE,pdb_dual:FILE,... - maximum of several"),
+        };
+    }
+
+    template<int Width, class Visitor>
+    static auto dispatch(const std::string& spec, Visitor&& visit) -> decltype(visit(Manhattan<Width>())) {
+        if (spec == Manhattan<Width>::name()) return visit(Manhattan<Width>());
+        if (spec == LinearConflict<Width>::name()) return visit(LinearConflict<Width>());
+        if (spec == WalkingDistance<Width>::name()) return visit(WalkingDistance<Width>());
+        if (spec == LegacyManhattan<Width>::name()) return visit(LegacyManhattan<Width>());
+        if (spec == LegacyLinearConflict<Width>::name()) return visit(LegacyLinearConflict<Width>());
+        if (spec == LegacyWalkingDistance<Width>::name()) return visit(LegacyWalkingDistance<Width>());
+        if (spec == InversionDistance<Width>::name()) return visit(InversionDistance<Width>());
+
+        if (spec.rfind("pdb:", 0) == 0 && spec.find(',') == std::string::npos) {
+            PatternDatabase database(spec.substr(4));
+            if (database.get_width() != Width) throw std::invalid_argument(spec + " is for another board width");
+            if (database.get_encoding() == PatternDatabase::modulo_three) return visit(ModuloPatternHeuristic(database));
+            return visit(PatternHeuristic(database));
+        }
+        if (spec.rfind("pdb_reflected:", 0) == 0 && spec.find(',') == std::string::npos) {
+            PatternDatabase database(spec.substr(14));
+            if (database.get_width() != Width) throw std::invalid_argument(spec + " is for another board width");
+            return visit(ReflectedPatternHeuristic(database));
+        }
+        if (spec.rfind("max:", 0) == 0) return visit(MaxHeuristic<Width>(spec.substr(4)));
+        if (spec.find(',') != std::string::npos) return visit(MaxHeuristic<Width>(spec));
+        throw std::invalid_argument("unknown heuristic " + spec + " (see --list-heuristics)");
+    }
+
+private:
+    template<class Heuristic>
+    static HeuristicInfo info(const std::string& description) {
+        return HeuristicInfo{Heuristic::name(), Heuristic::is_admissible, Heuristic::is_consistent, description};
+    }
+};
+
+
+#endif //HEURISTICREGISTRY_H
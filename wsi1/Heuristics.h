@@ -0,0 +1,175 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef HEURISTICS_H
+#define HEURISTICS_H
+#include <cstdint>
+#include <cstdlib>
+#include <unordered_map>
+#include <vector>
+
+
+// Admissible estimates for a Width x Width board with tile t at home in cell t - 1
+// and the blank in the last cell.
+//
+// Each of them is a heuristic strategy the search engines take as a template
+// parameter (see IdaStar): a name, evaluate(), update() after a move and
+// whether it is admissible / consistent. update() gets the parent's value and
+// the tile that slid from `from` to `to`; `limit` is where the node gets cut
+// off, an estimate may stop refining once it is above.
+struct ScalarHeuristic {
+    typedef int value_type;
+    static int cost(int value) { return value; }
+};
+
+template<int Width>
+class Manhattan : public ScalarHeuristic {
+public:
+    static const char* name() { return "manhattan"; }
+    static constexpr bool is_admissible = true, is_consistent = true;
+
+    // only the tile that slid changes its distance
+    static int update(int parent, const char*, char tile, int from, int to, int) {
+        int home = tile - 1;
+        return parent - std::abs(from % Width - home % Width) - std::abs(from / Width - home / Width)
+               + std::abs(to % Width - home % Width) + std::abs(to / Width - home / Width);
+    }
+
+    static int evaluate(const char* game_state) {
+        int sum = 0;
+        for (int i = 0; i < Width * Width; i++) {
+            if (game_state[i] == 0) continue;
+            int home = game_state[i] - 1;
+            sum += std::abs(i % Width - home % Width) + std::abs(i / Width - home / Width);
+        }
+        return sum;
+    }
+};
+
+// Manhattan distance plus two moves for every tile that has to leave its row
+// (or column) so the others in their goal row can pass each other: in a line,
+// tiles at home in that line but in the wrong order need all but a longest
+// increasing run of them to step aside.
+template<int Width>
+class LinearConflict : public ScalarHeuristic {
+public:
+    static const char* name() { return "linear_conflict"; }
+    static constexpr bool is_admissible = true, is_consistent = true;
+
+    static int update(int, const char* game_state, char, int, int, int) { return evaluate(game_state); }
+
+    static int evaluate(const char* game_state) {
+        int sum = Manhattan<Width>::evaluate(game_state);
+        for (int line = 0; line < Width; line++) {
+            sum += 2 * (conflicts(game_state, line, true) + conflicts(game_state, line, false));
+        }
+        return sum;
+    }
+
+private:
+    static int conflicts(const char* game_state, int line, bool row) {
+        int order[Width], count = 0;
+        for (int i = 0; i < Width; i++) {
+            char tile = game_state[row ? line * Width + i : i * Width + line];
+            if (tile == 0) continue;
+            int home = tile - 1;
+            if ((row ? home / Width : home % Width) == line) order[count++] = row ? home % Width : home / Width;
+        }
+        int longest[Width], best = 0;
+        for (int i = 0; i < count; i++) {
+            longest[i] = 1;
+            for (int j = 0; j < i; j++) {
+                if (order[j] < order[i] && longest[j] + 1 > longest[i]) longest[i] = longest[j] + 1;
+            }
+            if (longest[i] > best) best = longest[i];
+        }
+        return count - best;
+    }
+};
+
+// Walking distance: the rows alone form a smaller puzzle, counts[r][g] tiles
+// of goal row g sit in row r and a vertical move carries one tile into the
+// blank's row. Its exact distances, once for the rows and once for the
+// columns (the same puzzle transposed), add up to an admissible estimate.
+// The table is a breadth-first search built at first use.
+template<int Width>
+class WalkingDistance : public ScalarHeuristic {
+    static_assert(Width >= 2 && Width <= 5, "walking distance keys hold boards up to 5x5");
+
+public:
+    static const char* name() { return "walking_distance"; }
+    static constexpr bool is_admissible = true, is_consistent = true;
+
+    static int update(int, const char* game_state, char, int, int, int) { return evaluate(game_state); }
+
+    static int evaluate(const char* game_state) {
+        const auto& table = distances();
+        int rows[Width][Width] = {}, columns[Width][Width] = {};
+        int blank_row = 0, blank_column = 0;
+        for (int i = 0; i < Width * Width; i++) {
+            if (game_state[i] == 0) {
+                blank_row = i / Width;
+                blank_column = i % Width;
+                continue;
+            }
+            int home = game_state[i] - 1;
+            rows[i / Width][home / Width]++;
+            columns[i % Width][home % Width]++;
+        }
+        auto vertical = table.find(key(rows, blank_row)), horizontal = table.find(key(columns, blank_column));
+        return (vertical == table.end() ? 0 : vertical->second) + (horizontal == table.end() ? 0 : horizontal->second);
+    }
+
+    static size_t size() { return distances().size(); }
+
+private:
+    // the last goal row's count follows from the row sums, the blank row does not
+    static uint64_t key(const int counts[Width][Width], int blank_row) {
+        uint64_t result = static_cast<uint64_t>(blank_row);
+        for (int r = 0; r < Width; r++) {
+            for (int g = 0; g < Width - 1; g++) result = result * (Width + 1) + static_cast<uint64_t>(counts[r][g]);
+        }
+        return result;
+    }
+
+    struct Configuration {
+        int counts[Width][Width];
+        int blank_row;
+    };
+
+    static const std::unordered_map<uint64_t, uint8_t>& distances() {
+        static const std::unordered_map<uint64_t, uint8_t> table = build();
+        return table;
+    }
+
+    static std::unordered_map<uint64_t, uint8_t> build() {
+        std::unordered_map<uint64_t, uint8_t> table;
+        std::vector<Configuration> queue;
+        Configuration goal{};
+        for (int r = 0; r < Width; r++) goal.counts[r][r] = r == Width - 1 ? Width - 1 : Width;
+        goal.blank_row = Width - 1;
+        table[key(goal.counts, goal.blank_row)] = 0;
+        queue.push_back(goal);
+
+        for (size_t head = 0; head < queue.size(); head++) {
+            Configuration current = queue[head];
+            uint8_t next_distance = static_cast<uint8_t>(table[key(current.counts, current.blank_row)] + 1);
+            for (int neighbour = current.blank_row - 1; neighbour <= current.blank_row + 1; neighbour += 2) {
+                if (neighbour < 0 || neighbour >= Width) continue;
+                for (int g = 0; g < Width; g++) {
+                    if (current.counts[neighbour][g] == 0) continue;
+                    Configuration next = current;
+                    next.counts[neighbour][g]--;
+                    next.counts[current.blank_row][g]++;
+                    next.blank_row = neighbour;
+                    if (table.emplace(key(next.counts, next.blank_row), next_distance).second) queue.push_back(next);
+                }
+            }
+        }
+        return table;
+    }
+};
+
+
+#endif //HEURISTICS_H
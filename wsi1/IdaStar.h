@@ -0,0 +1,190 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef IDASTAR_H
+#define IDASTAR_H
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <stdexcept>
+#include "EndgameTable.h"
+#include "Inversions.h"
+#include "MovePruning.h"
+#include "MoveString.h"
+#include "PackedState.h"
+#include "Solution.h"
+#include "TranspositionTable.h"
+
+
+// Iterative deepening A* for a Width x Width board. The heuristic is a template
+// parameter so its calls are resolved (and inlined) at compile time. It has to
+// provide
+//   typedef ... value_type;                       what a node remembers of its estimate
+//   value_type evaluate(const char* game_state) const;
+//   value_type update(const value_type& parent, const char* game_state, char tile, int from, int to, int limit) const;
+//                                                 after `tile` slid from cell `from` to cell `to`; once the
+//                                                 estimate exceeds `limit` the node is cut off, so a cheaper
+//                                                 lower bound above it is just as good
+//   static int cost(const value_type& value);     the estimate itself
+// The search keeps a single board and undoes every move on the way back, so
+// memory stays linear in the solution length. Every node carries a state of
+// the move-pruning machine instead of a closed set; the default one only
+// forbids undoing the last move, a longer one (MovePruning::standard()) also
+// skips the short cycles of the blank. A TranspositionTable (use_table(),
+// boards up to 4x4) trades a fixed amount of memory for fewer revisits.
+//
+// Perimeter search (use_perimeter(), 4x4): an EndgameTable holds every board
+// within its radius of the goal with the exact distance. A node inside it
+// ends the search - within the bound the table's moves finish the path, else
+// the exact f is passed up - and any node outside is at least one move past
+// the rim, which lifts a weaker estimate there. The table is only probed
+// where the estimate does not already place the node outside.
+template<int Width, class Heuristic>
+class IdaStar {
+public:
+    static constexpr int cells = Width * Width;
+
+    explicit IdaStar(const Heuristic& _heuristic, const MovePruning& _pruning = MovePruning::inverse_moves())
+            : heuristic(_heuristic), pruning(_pruning) {}
+
+    static constexpr int found = -1;
+
+    // throws std::runtime_error for a permutation that cannot reach the goal
+    Solution solve(const char* game_state) {
+        if (!is_solvable(game_state)) {
+            throw std::runtime_error("given starting permutation is not solvable!\n");
+        }
+        Solution solution(game_state, Width);
+        std::copy(game_state, game_state + cells, board);
+        int blank = static_cast<int>(std::find(board, board + cells, 0) - board);
+        path.clear();
+        nodes_expanded = 0;
+        if (table != nullptr) table->new_generation();
+
+        value_type root = heuristic.evaluate(board);
+        int bound = Heuristic::cost(root);
+        while (true) {
+            int next_bound = search(blank, 0, bound, root, MovePruning::start);
+            if (next_bound == found) break;
+            bound = next_bound;
+        }
+        solution.moves = path;
+        solution.nodes_expanded = nodes_expanded;
+        return solution;
+    }
+
+    unsigned long long get_nodes_expanded() const { return nodes_expanded; }
+
+    // nullptr (the default) searches without memory; the table may be shared with other searches
+    void use_table(TranspositionTable* _table) {
+        if (_table != nullptr && cells > 16) throw std::invalid_argument("transposition tables hold boards up to 4x4");
+        table = _table;
+    }
+    // nullptr (the default) searches without a perimeter
+    void use_perimeter(const EndgameTable* _perimeter) {
+        if (_perimeter != nullptr && Width != Solver::Node::grid_size) throw std::invalid_argument("the endgame table holds 4x4 boards");
+        perimeter = _perimeter;
+    }
+    // once the flag is set every search under way returns as soon as it can, found or not
+    void use_stop_flag(const std::atomic<bool>* _stop) { stop = _stop; }
+
+    // A single iteration below a node g moves into a longer search, reached in
+    // state `state` of the move-pruning machine: found, with the moves from
+    // that node in get_path(), or the smallest f above the bound. Counts into
+    // get_nodes_expanded() without resetting it - the pieces ParallelIdaStar
+    // splits an iteration into.
+    int iterate(const char* game_state, int g, int bound, int state) {
+        std::copy(game_state, game_state + cells, board);
+        int blank = static_cast<int>(std::find(board, board + cells, 0) - board);
+        path.clear();
+        return search(blank, g, bound, heuristic.evaluate(board), state);
+    }
+    const MoveString& get_path() const { return path; }
+
+    static bool is_solvable(const char* game_state) { return Inversions::is_solvable(game_state, Width); }
+
+private:
+    typedef typename Heuristic::value_type value_type;
+    static constexpr int offsets[4] = {-Width, Width, -1, 1}; // indexed by move code
+
+    const Heuristic& heuristic;
+    const MovePruning& pruning;
+    TranspositionTable* table = nullptr;
+    const EndgameTable* perimeter = nullptr;
+    const std::atomic<bool>* stop = nullptr;
+    char board[cells];
+    MoveString path;
+    unsigned long long nodes_expanded = 0;
+
+    static bool is_goal(const char* game_state) {
+        for (int i = 0; i < cells - 1; i++) {
+            if (game_state[i] != i + 1) return false;
+        }
+        return true;
+    }
+
+    // found, or the smallest f above the bound seen below this node
+    int search(int blank, int g, int bound, const value_type& value, int state) {
+        int h = Heuristic::cost(value);
+        if (g + h > bound) return g + h;
+        if (h == 0 && is_goal(board)) return found;
+        if (stop != nullptr && stop->load(std::memory_order_relaxed)) return INT_MAX;
+        uint64_t key = 0;
+        if constexpr (cells <= 16) {
+            if (table != nullptr || perimeter != nullptr) key = PackedState<Width>::pack(board);
+        }
+        if constexpr (Width == Solver::Node::grid_size) {
+            if (perimeter != nullptr) {
+                int exact = h <= perimeter->get_radius() ? perimeter->distance(key) : -1;
+                if (exact >= 0) {
+                    if (g + exact > bound) return g + exact;
+                    path.append(perimeter->finish(key));
+                    return found;
+                }
+                //// past the rim, with the parity of the blank's way home
+                int rim = perimeter->get_radius() + 1;
+                rim += (rim + blank % Width + blank / Width) % 2;
+                if (g + rim > bound) return g + rim;
+            }
+        }
+        if constexpr (cells <= 16) {
+            if (table != nullptr) {
+                int known = table->lookup(key, static_cast<uint32_t>(state));
+                if (g + known > bound) return g + known;
+            }
+        }
+        nodes_expanded++;
+
+        int next_bound = INT_MAX;
+        int x = blank % Width, y = blank / Width;
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            int next_state = pruning.next(state, move);
+            if (next_state == MovePruning::pruned) continue;
+            if ((move == MoveString::up && y == 0) || (move == MoveString::down && y == Width - 1)
+                || (move == MoveString::left && x == 0) || (move == MoveString::right && x == Width - 1)) continue;
+
+            int destination = blank + offsets[move];
+            char tile = board[destination];
+            board[blank] = tile;
+            board[destination] = 0;
+            path.push_back(move);
+
+            int t = search(destination, g + 1, bound, heuristic.update(value, board, tile, destination, blank, bound - g - 1), next_state);
+            if (t == found) return found;
+            next_bound = std::min(next_bound, t);
+
+            path.pop_back();
+            board[destination] = tile;
+            board[blank] = 0;
+        }
+        if (table != nullptr && next_bound != INT_MAX && !(stop != nullptr && stop->load(std::memory_order_relaxed))) {
+            //// no path out of here within the bound: nothing shorter than next_bound - g is left below
+            table->store(key, static_cast<uint32_t>(state), next_bound - g, bound - g);
+        }
+        return next_bound;
+    }
+};
+
+
+#endif //IDASTAR_H
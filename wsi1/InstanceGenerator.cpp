@@ -0,0 +1,98 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "InstanceGenerator.h"
+#include <algorithm>
+#include <stdexcept>
+#include "MoveString.h"
+
+
+Xoshiro256::Xoshiro256(uint64_t seed) {
+    for (auto& word : state) {
+        seed += 0x9E3779B97F4A7C15ULL;
+        uint64_t z = seed;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        word = z ^ (z >> 31);
+    }
+}
+
+
+InstanceGenerator::InstanceGenerator(int _width, uint64_t seed)
+        : width(_width), cells(_width * _width), random_source(seed) {
+    if (width < 2 || cells > 128) throw std::invalid_argument("board width has to be between 2 and 11");
+}
+
+void InstanceGenerator::goal(int width, char* board) {
+    for (int cell = 0; cell < width * width; cell++) board[cell] = static_cast<char>((cell + 1) % (width * width));
+}
+
+void InstanceGenerator::random(char* board) {
+    goal(width, board);
+    bool odd = false;
+    for (int i = cells - 1; i > 0; i--) {
+        int j = static_cast<int>(random_source.below(static_cast<uint32_t>(i + 1)));
+        if (j == i) continue;
+        std::swap(board[i], board[j]);
+        odd = !odd;
+    }
+
+    //// every move of the blank is one transposition and takes it one cell
+    //// closer to or further from its goal cell, so the two parities agree
+    int blank = 0;
+    while (board[blank] != 0) blank++;
+    int blank_distance = (width - 1 - blank % width) + (width - 1 - blank / width);
+    if (odd == (blank_distance % 2 == 1)) return;
+    int first = blank == 0 ? 1 : 0;
+    int second = blank == first + 1 ? first + 2 : first + 1;
+    std::swap(board[first], board[second]);
+}
+
+std::vector<char> InstanceGenerator::random() {
+    std::vector<char> board(static_cast<size_t>(cells));
+    random(board.data());
+    return board;
+}
+
+void InstanceGenerator::walk(int length, char* board) {
+    goal(width, board);
+    int blank = cells - 1, previous = -1;
+    for (int step = 0; step < length;) {
+        int move = static_cast<int>(random_source.below(4));
+        int x = blank % width, y = blank / width;
+        if ((previous >= 0 && move == MoveString::inverse(previous))
+            || (move == MoveString::up && y == 0) || (move == MoveString::down && y == width - 1)
+            || (move == MoveString::left && x == 0) || (move == MoveString::right && x == width - 1)) continue;
+        blank = MoveString::apply(board, width, blank, move);
+        previous = move;
+        step++;
+    }
+}
+
+bool InstanceGenerator::at_distance(int distance, const DistanceOracle& oracle, char* board, int attempts) {
+    std::vector<char> child(static_cast<size_t>(cells));
+    for (int attempt = 0; attempt < attempts; attempt++) {
+        goal(width, board);
+        int blank = cells - 1, previous = -1;
+        int reached = 0;
+        for (; reached < distance; reached++) {
+            //// a move changes the distance by exactly one; keep the ones going out
+            int further[4], count = 0;
+            int x = blank % width, y = blank / width;
+            for (int move = MoveString::up; move <= MoveString::right; move++) {
+                if ((previous >= 0 && move == MoveString::inverse(previous))
+                    || (move == MoveString::up && y == 0) || (move == MoveString::down && y == width - 1)
+                    || (move == MoveString::left && x == 0) || (move == MoveString::right && x == width - 1)) continue;
+                std::copy(board, board + cells, child.begin());
+                MoveString::apply(child.data(), width, blank, move);
+                if (oracle(child.data()) == reached + 1) further[count++] = move;
+            }
+            if (count == 0) break;
+            previous = further[random_source.below(static_cast<uint32_t>(count))];
+            blank = MoveString::apply(board, width, blank, previous);
+        }
+        if (reached == distance) return true;
+    }
+    return false;
+}
@@ -0,0 +1,95 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef INSTANCEGENERATOR_H
+#define INSTANCEGENERATOR_H
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+
+// xoshiro256** - small, fast and good enough for shuffling boards; the four
+// words of state are spread out of the seed with splitmix64
+class Xoshiro256 {
+public:
+    explicit Xoshiro256(uint64_t seed);
+
+    uint64_t operator()() {
+        uint64_t result = rotate(state[1] * 5, 7) * 9;
+        uint64_t shifted = state[1] << 17;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= shifted;
+        state[3] = rotate(state[3], 45);
+        return result;
+    }
+
+    // uniform in [0, n), Lemire's multiply-and-reject
+    uint32_t below(uint32_t n) {
+        uint64_t product = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * n;
+        if (static_cast<uint32_t>(product) < n) {
+            uint32_t threshold = static_cast<uint32_t>(-n) % n;
+            while (static_cast<uint32_t>(product) < threshold) {
+                product = static_cast<uint64_t>(static_cast<uint32_t>((*this)() >> 32)) * n;
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+    //// std::uniform_random_bit_generator, for std::shuffle and the distributions
+    typedef uint64_t result_type;
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return UINT64_MAX; }
+
+private:
+    uint64_t state[4];
+
+    static uint64_t rotate(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+};
+
+
+// Random boards for benchmarks and tests, goal as in Solver::Node::generate_target()
+// (tile t on cell t - 1, the blank last), every one of them solvable.
+//
+// random() is uniform over the solvable boards: a Fisher-Yates shuffle that
+// keeps track of its parity, then - for the unsolvable half - a swap of the
+// first two tiles. The swap pairs every unsolvable board with exactly one
+// solvable one, so nothing is rejected and nothing is favoured.
+//
+// at_distance() walks out of the goal and takes only moves that lead one step
+// further away according to a distance oracle - EightPuzzleTable, EndgameTable
+// inside its radius or an optimal solve - so the board it ends on is exactly
+// that far. Such boards are not uniform over their distance layer.
+class InstanceGenerator {
+public:
+    // the exact number of moves between a board and the goal, -1 when unknown
+    typedef std::function<int(const char*)> DistanceOracle;
+
+    InstanceGenerator(int _width, uint64_t seed);
+
+    int get_width() const { return width; }
+    Xoshiro256& get_random() { return random_source; }
+
+    void random(char* board);
+    std::vector<char> random();
+
+    // `length` moves of the blank out of the goal, never undoing the last one
+    void walk(int length, char* board);
+
+    // false when every one of `attempts` walks got stuck before `distance`
+    // (no neighbour further away, or one the oracle does not know)
+    bool at_distance(int distance, const DistanceOracle& oracle, char* board, int attempts = 100);
+
+    static void goal(int width, char* board);
+
+private:
+    int width;
+    int cells;
+    Xoshiro256 random_source;
+};
+
+
+#endif //INSTANCEGENERATOR_H
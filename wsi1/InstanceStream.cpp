@@ -0,0 +1,161 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "InstanceStream.h"
+#include <sstream>
+#include <stdexcept>
+#include <cctype>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+
+
+static int board_width(size_t num_of_tiles) {
+    int width = static_cast<int>(std::lround(std::sqrt(static_cast<double>(num_of_tiles))));
+    if (width < 2 || static_cast<size_t>(width * width) != num_of_tiles) {
+        return -1;
+    }
+    return width;
+}
+
+// every tile from 0 to n-1 has to appear exactly once
+static bool is_permutation(const std::vector<int>& tiles) {
+    std::vector<bool> seen(tiles.size(), false);
+    for (int tile : tiles) {
+        if (tile < 0 || tile >= static_cast<int>(tiles.size()) || seen[tile])
+            return false;
+        seen[tile] = true;
+    }
+    return true;
+}
+
+static int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    c = static_cast<char>(std::tolower(c));
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool InstanceReader::next(Instance& instance) {
+    bool read = binary ? next_binary(instance) : next_text(instance);
+    if (!read) return false;
+
+    instance.id = next_id++;
+    if (!is_permutation(instance.tiles)) {
+        throw std::invalid_argument("instance " + std::to_string(instance.id) + " is not a permutation of 0.." + std::to_string(instance.tiles.size() - 1));
+    }
+    return true;
+}
+
+bool InstanceReader::next_text(Instance& instance) {
+    std::string line;
+    while (std::getline(input, line)) {
+        line_number++;
+        line.erase(std::find(line.begin(), line.end(), '#'), line.end());
+
+        std::istringstream tokens(line);
+        std::vector<std::string> words;
+        std::string word;
+        while (tokens >> word) words.push_back(word);
+        if (words.empty()) continue;
+
+        instance.tiles.clear();
+        if (words.size() == 1) {
+            //// compact hex
+            const std::string& hex = words.front();
+            int width = board_width(hex.size());
+            int digits_per_tile = 1;
+            if (width == -1 || width * width > 16) {
+                width = hex.size() % 2 == 0 ? board_width(hex.size() / 2) : -1;
+                digits_per_tile = 2;
+            }
+            if (width == -1) {
+                throw std::invalid_argument("line " + std::to_string(line_number) + ": hex board has no square size");
+            }
+            for (size_t i = 0; i < hex.size(); i += digits_per_tile) {
+                int tile = 0;
+                for (int d = 0; d < digits_per_tile; d++) {
+                    int digit = hex_digit(hex[i + d]);
+                    if (digit == -1) {
+                        throw std::invalid_argument("line " + std::to_string(line_number) + ": not a hex digit");
+                    }
+                    tile = tile * 16 + digit;
+                }
+                instance.tiles.push_back(tile);
+            }
+            instance.width = width;
+        } else {
+            //// whitespace separated
+            for (const auto& w : words) {
+                size_t used = 0;
+                int tile = -1;
+                try {
+                    tile = std::stoi(w, &used);
+                } catch (const std::exception&) {
+                    used = 0;
+                }
+                if (used != w.size()) {
+                    throw std::invalid_argument("line " + std::to_string(line_number) + ": '" + w + "' is not a tile");
+                }
+                instance.tiles.push_back(tile);
+            }
+            instance.width = board_width(instance.tiles.size());
+            if (instance.width == -1) {
+                throw std::invalid_argument("line " + std::to_string(line_number) + ": number of tiles is not a square");
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool InstanceReader::next_binary(Instance& instance) {
+    int width = input.get();
+    if (width == std::char_traits<char>::eof()) return false;
+    if (width < 2) {
+        throw std::invalid_argument("binary record with board width " + std::to_string(width));
+    }
+
+    size_t num_of_tiles = static_cast<size_t>(width) * width;
+    bool wide = num_of_tiles > 256;
+    std::vector<unsigned char> raw(num_of_tiles * (wide ? 2 : 1));
+    if (!input.read(reinterpret_cast<char*>(raw.data()), static_cast<std::streamsize>(raw.size()))) {
+        throw std::invalid_argument("truncated binary record");
+    }
+
+    instance.width = width;
+    instance.tiles.resize(num_of_tiles);
+    for (size_t i = 0; i < num_of_tiles; i++) {
+        instance.tiles[i] = wide ? raw[2 * i] | (raw[2 * i + 1] << 8) : raw[i];
+    }
+    return true;
+}
+
+
+template<typename T>
+static void write_raw(std::ostream& output, T value) {
+    output.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void ResultWriter::write(const SolveRecord& record) {
+    if (!binary) {
+        output << record.id << ' ' << record.length << ' '
+               << (record.moves.empty() ? "-" : record.moves.to_string()) << ' '
+               << record.nodes_expanded << ' ' << record.seconds << '\n';
+        output.flush();
+        return;
+    }
+
+    if (record.length > INT16_MAX) {
+        throw std::invalid_argument("a path of " + std::to_string(record.length) + " moves does not fit a binary record, write text");
+    }
+    write_raw(output, static_cast<uint32_t>(record.id));
+    write_raw(output, static_cast<int16_t>(record.length));
+    write_raw(output, static_cast<uint64_t>(record.nodes_expanded));
+    write_raw(output, record.seconds);
+
+    const auto& packed = record.moves.bytes();
+    output.write(reinterpret_cast<const char*>(packed.data()), static_cast<std::streamsize>(packed.size()));
+    output.flush();
+}
@@ -0,0 +1,73 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef INSTANCESTREAM_H
+#define INSTANCESTREAM_H
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "MoveString.h"
+
+
+// One puzzle per record. The board width is deduced from the number of tiles.
+//
+// text input, one instance per line ('#' starts a comment, empty lines are skipped):
+//   1 2 3 4 5 6 7 8 9 10 11 12 13 14 0 15     - whitespace separated tiles
+//   123456789abcde0f                          - compact hex, one digit per tile
+//   0102030405...                             - compact hex, two digits per tile
+// binary input record:
+//   u8 width, then width*width tiles (u8 each, u16 when there are more than 256 tiles)
+struct Instance {
+    unsigned long id = 0;
+    int width = 0;
+    std::vector<int> tiles;
+};
+
+class InstanceReader {
+public:
+    InstanceReader(std::istream& _input, bool _binary) : input(_input), binary(_binary) {}
+    bool next(Instance& instance); // false at the end of the stream, throws on a malformed record
+
+private:
+    std::istream& input;
+    bool binary;
+    unsigned long next_id = 0;
+    unsigned long line_number = 0;
+
+    bool next_text(Instance& instance);
+    bool next_binary(Instance& instance);
+};
+
+
+// One result per instance, flushed right away so consumers can pipeline.
+//
+// text record:
+//   <id> <length> <moves> <nodes expanded> <seconds>
+//   moves are the directions the blank travels (U, D, L, R), "-" for an empty path,
+//   length is -1 (and moves "-") when the instance could not be solved
+// binary record:
+//   u32 id, i16 length, u64 nodes expanded, f64 seconds, then the ceil(length / 4)
+//   bytes of MoveString (2 bits per move, U = 0, D = 1, L = 2, R = 3, lowest bits first)
+struct SolveRecord {
+    unsigned long id = 0;
+    int length = -1;
+    MoveString moves;
+    unsigned long long nodes_expanded = 0;
+    double seconds = 0;
+};
+
+class ResultWriter {
+public:
+    ResultWriter(std::ostream& _output, bool _binary) : output(_output), binary(_binary) {}
+    void write(const SolveRecord& record);
+
+private:
+    std::ostream& output;
+    bool binary;
+};
+
+
+#endif //INSTANCESTREAM_H
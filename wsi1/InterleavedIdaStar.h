@@ -0,0 +1,284 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef INTERLEAVEDIDASTAR_H
+#define INTERLEAVEDIDASTAR_H
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "IdaStar.h"
+
+
+// IDA* over many instances at once on a single thread. Every search is a
+// state machine with an explicit stack, and the searches take turns one step
+// each: a step finishes the move started on the search's previous turn - by
+// now the table entries its child needs have had the other streams' steps to
+// arrive from memory - then starts the next move: applies it, works out which
+// entries that child will need and prefetches them. With table-based estimates
+// (pattern databases, a transposition table) a single search spends most of
+// its time waiting on such misses; this overlaps them.
+//
+// Heuristics that split update() into prepare() + complete() (see
+// PatternHeuristic) get their lookups prefetched, the others are updated
+// when the move finishes, as usual. Each search finds the same path
+// IdaStar would.
+//
+// Experimental: it does not pay off yet. Even over a 5x5 6-6-6-6 database
+// (510 MB, far past the cache) IdaStar takes about 205 ns a node and this
+// about 370, with 4, 8 or 16 streams alike - the bookkeeping of a turn per
+// child costs more than the misses it hides.
+template<int Width, class Heuristic>
+class InterleavedIdaStar {
+public:
+    static constexpr int cells = Width * Width;
+    static constexpr int default_streams = 8;
+
+    explicit InterleavedIdaStar(const Heuristic& _heuristic, int _streams = default_streams,
+                                const MovePruning& _pruning = MovePruning::inverse_moves())
+            : heuristic(_heuristic), streams(std::max(_streams, 1)), pruning(_pruning) {}
+
+    // shared by all the streams; nullptr (the default) searches without one
+    void use_table(TranspositionTable* _table) {
+        if (_table != nullptr && cells > 16) throw std::invalid_argument("transposition tables hold boards up to 4x4");
+        table = _table;
+    }
+
+    // Solves boards pulled from `next(std::vector<char>& board, unsigned long& tag)`
+    // (false once there are none left) and hands each result to
+    // `done(unsigned long tag, const Solution* solution)` as soon as it is
+    // found - in the order they finish, nullptr for boards that cannot reach
+    // the goal.
+    template<class Source, class Sink>
+    void run(Source&& next, Sink&& done) {
+        std::vector<Stream> slots(static_cast<size_t>(streams));
+        if (table != nullptr) table->new_generation();
+        bool more = true;
+        size_t active = 0;
+        auto refill = [&](Stream& stream) {
+            std::vector<char> board;
+            while (more) {
+                more = next(board, stream.tag);
+                if (!more) break;
+                if (!IdaStar<Width, Heuristic>::is_solvable(board.data())) {
+                    done(stream.tag, static_cast<const Solution*>(nullptr));
+                    continue;
+                }
+                start(stream, board.data());
+                if (stream.active) {
+                    active++;
+                    return;
+                }
+                done(stream.tag, &stream.solution); // already at the goal
+            }
+        };
+        for (auto& stream : slots) refill(stream);
+
+        while (active > 0) {
+            for (auto& stream : slots) {
+                if (!stream.active) continue;
+                step(stream);
+                if (stream.active) continue;
+                active--;
+                done(stream.tag, &stream.solution);
+                refill(stream);
+            }
+        }
+    }
+
+    // throws std::runtime_error when one of the boards cannot reach the goal
+    std::vector<Solution> solve(const std::vector<std::vector<char>>& boards) {
+        std::vector<Solution> solutions(boards.size());
+        size_t given = 0;
+        bool unsolvable = false;
+        run([&](std::vector<char>& board, unsigned long& tag) {
+                if (given == boards.size()) return false;
+                board = boards[given];
+                tag = given++;
+                return true;
+            },
+            [&](unsigned long tag, const Solution* solution) {
+                if (solution == nullptr) unsolvable = true;
+                else solutions[tag] = *solution;
+            });
+        if (unsolvable) throw std::runtime_error("given starting permutation is not solvable!\n");
+        return solutions;
+    }
+
+private:
+    typedef typename Heuristic::value_type value_type;
+
+    template<class H, class = void>
+    struct splits_update : std::false_type {};
+    template<class H>
+    struct splits_update<H, std::void_t<decltype(std::declval<const H&>().prepare(nullptr, char()))>> : std::true_type {};
+
+    // what prepare() hands over to complete(), nothing without them
+    template<class H, bool = splits_update<H>::value>
+    struct pending_of {
+        struct type {};
+    };
+    template<class H>
+    struct pending_of<H, true> {
+        typedef decltype(std::declval<const H&>().prepare(nullptr, char())) type;
+    };
+    typedef typename pending_of<Heuristic>::type pending_type;
+
+    struct Frame {
+        int blank;
+        value_type value;
+        int state; // of the move-pruning machine
+        int move; // the next one to try
+        int next_bound;
+        uint64_t key; // packed board, with a transposition table
+    };
+
+    struct Stream {
+        bool active = false;
+        unsigned long tag = 0;
+        Solution solution;
+        char board[cells];
+        std::vector<Frame> stack;
+        MoveString path;
+        int bound = 0;
+        //// the move started on the previous turn
+        bool pending = false;
+        int move = 0, state = 0, destination = 0;
+        char tile = 0;
+        pending_type lookup{};
+        uint64_t key = 0;
+    };
+
+    static constexpr int offsets[4] = {-Width, Width, -1, 1}; // indexed by move code
+
+    const Heuristic& heuristic;
+    int streams;
+    const MovePruning& pruning;
+    TranspositionTable* table = nullptr;
+
+    static bool is_goal(const char* game_state) {
+        for (int i = 0; i < cells - 1; i++) {
+            if (game_state[i] != i + 1) return false;
+        }
+        return true;
+    }
+
+    uint64_t key_of(const char* game_state) const {
+        if constexpr (cells <= 16) {
+            if (table != nullptr) return PackedState<Width>::pack(game_state);
+        }
+        return 0;
+    }
+
+    void start(Stream& stream, const char* game_state) {
+        stream.solution = Solution(game_state, Width);
+        std::copy(game_state, game_state + cells, stream.board);
+        stream.path.clear();
+        stream.pending = false;
+        stream.active = !is_goal(stream.board);
+        if (!stream.active) return;
+        value_type root = heuristic.evaluate(stream.board);
+        stream.bound = Heuristic::cost(root);
+        int blank = static_cast<int>(std::find(stream.board, stream.board + cells, 0) - stream.board);
+        stream.stack.assign(1, Frame{blank, root, MovePruning::start, MoveString::up, INT_MAX, key_of(stream.board)});
+        stream.solution.nodes_expanded = 1;
+    }
+
+    // finishes the move started on the previous turn and starts the next one
+    void step(Stream& stream) {
+        if (stream.pending) {
+            finish_move(stream);
+            if (!stream.active) return;
+        }
+        while (!start_move(stream)) back_up(stream);
+    }
+
+    // the next move out of the top node, false when it has none left
+    bool start_move(Stream& stream) {
+        Frame& top = stream.stack.back();
+        int x = top.blank % Width, y = top.blank / Width;
+        while (top.move <= MoveString::right) {
+            int move = top.move++;
+            int state = pruning.next(top.state, move);
+            if (state == MovePruning::pruned) continue;
+            if ((move == MoveString::up && y == 0) || (move == MoveString::down && y == Width - 1)
+                || (move == MoveString::left && x == 0) || (move == MoveString::right && x == Width - 1)) continue;
+
+            int destination = top.blank + offsets[move];
+            char tile = stream.board[destination];
+            stream.board[top.blank] = tile;
+            stream.board[destination] = 0;
+            if constexpr (splits_update<Heuristic>::value) stream.lookup = heuristic.prepare(stream.board, tile);
+            stream.key = key_of(stream.board);
+            if (table != nullptr) table->prefetch(stream.key, static_cast<uint32_t>(state));
+            stream.pending = true;
+            stream.move = move;
+            stream.state = state;
+            stream.destination = destination;
+            stream.tile = tile;
+            return true;
+        }
+        return false;
+    }
+
+    // the child of the move started last turn: cut off, the goal, or a new top node
+    void finish_move(Stream& stream) {
+        stream.pending = false;
+        Frame& top = stream.stack.back();
+        int g = static_cast<int>(stream.stack.size());
+        value_type value;
+        if constexpr (splits_update<Heuristic>::value) value = heuristic.complete(top.value, stream.lookup);
+        else value = heuristic.update(top.value, stream.board, stream.tile, stream.destination, top.blank, stream.bound - g);
+        int h = Heuristic::cost(value);
+
+        if (g + h <= stream.bound && h == 0 && is_goal(stream.board)) {
+            stream.path.push_back(stream.move);
+            stream.solution.moves = stream.path;
+            stream.active = false;
+            return;
+        }
+        if (g + h <= stream.bound && table != nullptr) {
+            h = std::max(h, table->lookup(stream.key, static_cast<uint32_t>(stream.state)));
+        }
+        if (g + h > stream.bound) {
+            top.next_bound = std::min(top.next_bound, g + h);
+            stream.board[stream.destination] = stream.tile;
+            stream.board[top.blank] = 0;
+            return;
+        }
+        stream.path.push_back(stream.move);
+        stream.solution.nodes_expanded++;
+        stream.stack.push_back(Frame{stream.destination, value, stream.state, MoveString::up, INT_MAX, stream.key});
+    }
+
+    // every move out of the top node is done: pass its bound up, or start the next iteration at the root
+    void back_up(Stream& stream) {
+        Frame done = stream.stack.back();
+        stream.stack.pop_back();
+        int g = static_cast<int>(stream.stack.size());
+        if (table != nullptr && done.next_bound != INT_MAX) {
+            table->store(done.key, static_cast<uint32_t>(done.state), done.next_bound - g, stream.bound - g);
+        }
+
+        if (stream.stack.empty()) {
+            if (done.next_bound == INT_MAX) throw std::runtime_error("search space exhausted without reaching the goal");
+            stream.bound = done.next_bound;
+            done.move = MoveString::up;
+            done.next_bound = INT_MAX;
+            stream.stack.push_back(done);
+            stream.solution.nodes_expanded++;
+            return;
+        }
+        Frame& parent = stream.stack.back();
+        stream.board[done.blank] = stream.board[parent.blank];
+        stream.board[parent.blank] = 0;
+        stream.path.pop_back();
+        parent.next_bound = std::min(parent.next_bound, done.next_bound);
+    }
+};
+
+
+#endif //INTERLEAVEDIDASTAR_H
@@ -0,0 +1,16 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "Inversions.h"
+
+
+size_t Inversions::is_solvable_batch(const char* boards, size_t count, int width, uint8_t* solvable) {
+    size_t cells = static_cast<size_t>(width) * static_cast<size_t>(width);
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        solvable[i] = is_solvable(boards + i * cells, width) ? 1 : 0;
+        total += solvable[i];
+    }
+    return total;
+}
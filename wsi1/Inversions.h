@@ -0,0 +1,73 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef INVERSIONS_H
+#define INVERSIONS_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Ranking.h"
+
+
+// Inversions of a board - pairs of tiles, the blank left out, standing in the
+// opposite order to the goal - and the solvability test built on them, for
+// boards of any width.
+//
+// Up to 64 cells a bitmask of the tiles seen so far answers "how many of them
+// are larger" with one popcount per cell; bigger boards count the same with a
+// Fenwick tree, O(n log n) either way instead of the O(n^2) pair loop.
+//
+// A move across a row keeps the inversion parity, a move along a column jumps
+// the tile over width - 1 others. So on odd widths the parity never changes
+// and the board is solvable when it is even; on even widths every row the
+// blank moves flips it, and the inversions plus the blank's row have to match
+// the goal's, blank on the last row and no inversions.
+class Inversions {
+public:
+    template<class Tile>
+    static long long count(const Tile* game_state, int cells) {
+        if (cells <= 64) {
+            long long inversions = 0;
+            uint64_t seen = 0;
+            for (int cell = 0; cell < cells; cell++) {
+                int tile = static_cast<int>(game_state[cell]);
+                if (tile == 0) continue;
+                inversions += Ranking::popcount((seen >> tile) >> 1); // the larger tiles before this one
+                seen |= uint64_t(1) << tile;
+            }
+            return inversions;
+        }
+
+        std::vector<int> tree(static_cast<size_t>(cells) + 1, 0);
+        long long inversions = 0;
+        int placed = 0;
+        for (int cell = 0; cell < cells; cell++) {
+            int tile = static_cast<int>(game_state[cell]);
+            if (tile == 0) continue;
+            int smaller = 0;
+            for (int i = tile; i > 0; i -= i & -i) smaller += tree[i];
+            inversions += placed - smaller;
+            for (int i = tile; i <= cells; i += i & -i) tree[i]++;
+            placed++;
+        }
+        return inversions;
+    }
+
+    template<class Tile>
+    static bool is_solvable(const Tile* game_state, int width) {
+        int cells = width * width;
+        long long inversions = count(game_state, cells);
+        if (width % 2 == 1) return inversions % 2 == 0;
+        int blank = 0;
+        while (game_state[blank] != 0) blank++;
+        return (inversions + blank / width) % 2 == (width - 1) % 2;
+    }
+
+    // `count` boards of width * width tiles stored back to back: solvable[i]
+    // for the i-th of them, returns how many are
+    static size_t is_solvable_batch(const char* boards, size_t count, int width, uint8_t* solvable);
+};
+
+
+#endif //INVERSIONS_H
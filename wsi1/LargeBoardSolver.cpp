@@ -0,0 +1,219 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "LargeBoardSolver.h"
+#include <algorithm>
+#include <stdexcept>
+#include "Inversions.h"
+#include "PathOptimizer.h"
+#include "Symmetry.h"
+
+static const uint8_t unvisited = 0xFF, start_state = 4;
+static const int row_step[4] = {-1, 1, 0, 0}, column_step[4] = {0, 0, -1, 1}; // indexed by move code
+
+
+MoveString LargeBoardSolver::solve(const tile_type* game_state, int _width) {
+    if (_width < EightPuzzleTable::width || _width > max_width) {
+        throw std::invalid_argument("the decomposition handles widths 3 to " + std::to_string(max_width));
+    }
+    width = _width;
+    int cells = width * width;
+    board.assign(game_state, game_state + cells);
+    position.assign(cells, -1);
+    for (int i = 0; i < cells; i++) {
+        if (board[i] >= cells || position[board[i]] != -1) throw std::invalid_argument("the board is not a permutation");
+        position[board[i]] = i;
+    }
+    if (!Inversions::is_solvable(board.data(), width)) {
+        throw std::runtime_error("given starting permutation is not solvable!\n");
+    }
+    fixed.assign(cells, 0);
+    blank = position[0];
+    moves.clear();
+    nodes_expanded = 0;
+
+    for (int k = 0; k + EightPuzzleTable::width < width; k++) {
+        transposed = false;
+        solve_line(k, k); // row k
+        transposed = true;
+        solve_line(k, k + 1); // column k, below the row
+    }
+    transposed = false;
+    finish_three_by_three();
+    return cancel_inverses ? PathOptimizer::cancel_inverses(moves) : moves;
+}
+
+int LargeBoardSolver::real_move(int move) const {
+    return transposed ? Symmetry::mirror_move(move) : move;
+}
+
+void LargeBoardSolver::slide(int move) {
+    int destination = blank + MoveString::offset(move, width);
+    tile_type tile = board[destination];
+    board[blank] = tile;
+    position[tile] = blank;
+    board[destination] = 0;
+    position[0] = destination;
+    blank = destination;
+    moves.push_back(move);
+}
+
+void LargeBoardSolver::solve_line(int line, int first) {
+    top = line;
+    left = first;
+    for (int column = first; column < width - 2; column++) {
+        place(goal_tile(line, column), line, column, -1);
+        fixed[cell(line, column)] = 1;
+    }
+
+    tile_type last_but_one = goal_tile(line, width - 2), last = goal_tile(line, width - 1);
+    if (position[last_but_one] != cell(line, width - 2) || position[last] != cell(line, width - 1)) {
+        //// park the first in the last cell and the second below it, then slide both in. The
+        //// second steps out of the way first: caught next to the parked one it would have no
+        //// way out, and off the edge it cannot wall in a corner the first may sit in
+        place(last, line + 2, width - 2, -1);
+        place(last_but_one, line, width - 1, cell(line + 2, width - 2));
+        place(last, line + 1, width - 1, cell(line, width - 1));
+        if (!route_blank(line, line, width - 2, width - 2, cell(line, width - 1), cell(line + 1, width - 1))) {
+            throw std::logic_error("the blank cannot reach the end of the line");
+        }
+        slide(real_move(MoveString::right));
+        slide(real_move(MoveString::down));
+    }
+    fixed[cell(line, width - 2)] = 1;
+    fixed[cell(line, width - 1)] = 1;
+}
+
+void LargeBoardSolver::place(tile_type tile, int row, int column, int locked) {
+    int target = cell(row, column);
+    //// long trips go in legs of at most leg_length rows and columns; where the diagonal
+    //// step would end on a placed tile the leg stays in the tile's row
+    while (position[tile] != target) {
+        int tile_row = row_of(position[tile]), tile_column = column_of(position[tile]);
+        int next_column = tile_column + std::max(-leg_length, std::min(leg_length, column - tile_column));
+        int next = cell(tile_row + std::max(-leg_length, std::min(leg_length, row - tile_row)), next_column);
+        if (fixed[next] || next == locked) next = cell(tile_row, next_column);
+        if (fixed[next] || next == locked || next == position[tile] || !place_box(tile, next, locked)) break;
+    }
+    if (position[tile] == target) return;
+    if (place_box(tile, target, locked)) return;
+    if (place_within(tile, target, locked, top, width - 1, left, width - 1)) return;
+    throw std::logic_error("no way to bring tile " + std::to_string(tile) + " home");
+}
+
+bool LargeBoardSolver::place_box(tile_type tile, int target, int locked) {
+    int tile_row = row_of(position[tile]), tile_column = column_of(position[tile]);
+    int row = row_of(target), column = column_of(target);
+    int row_from = std::max(std::min(tile_row, row) - 1, top), row_to = std::min(std::max(tile_row, row) + 1, width - 1);
+    int column_from = std::max(std::min(tile_column, column) - 1, left), column_to = std::min(std::max(tile_column, column) + 1, width - 1);
+
+    //// a blank far away would stretch the box, it walks over first
+    route_blank(row_from, row_to, column_from, column_to, position[tile], locked);
+    row_from = std::min(row_from, row_of(blank));
+    row_to = std::max(row_to, row_of(blank));
+    column_from = std::min(column_from, column_of(blank));
+    column_to = std::max(column_to, column_of(blank));
+    return place_within(tile, target, locked, row_from, row_to, column_from, column_to);
+}
+
+bool LargeBoardSolver::place_within(tile_type tile, int target, int locked, int row_from, int row_to, int column_from, int column_to) {
+    int box_width = column_to - column_from + 1, n = (row_to - row_from + 1) * box_width;
+    auto local = [&](int real_cell) { return (row_of(real_cell) - row_from) * box_width + column_of(real_cell) - column_from; };
+    auto open = [&](int row, int column) {
+        if (row < row_from || row > row_to || column < column_from || column > column_to) return false;
+        int real_cell = cell(row, column);
+        return !fixed[real_cell] && real_cell != locked;
+    };
+
+    came_by.assign(static_cast<size_t>(n) * n, unvisited);
+    queue.clear();
+    int start = local(position[tile]) * n + local(blank), goal = local(target), found = -1;
+    came_by[start] = start_state;
+    queue.push_back(start);
+    for (size_t head = 0; head < queue.size() && found < 0; head++) {
+        int state = queue[head], tile_cell = state / n, blank_cell = state % n;
+        nodes_expanded++;
+        int blank_row = row_from + blank_cell / box_width, blank_column = column_from + blank_cell % box_width;
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if (!open(blank_row + row_step[move], blank_column + column_step[move])) continue;
+            int next_blank = blank_cell + row_step[move] * box_width + column_step[move];
+            int next_tile = next_blank == tile_cell ? blank_cell : tile_cell;
+            int next = next_tile * n + next_blank;
+            if (came_by[next] != unvisited) continue;
+            came_by[next] = static_cast<uint8_t>(move);
+            if (next_tile == goal) {
+                found = next;
+                break;
+            }
+            queue.push_back(next);
+        }
+    }
+    if (found < 0) return false;
+
+    //// back from the goal: the blank came from one step behind, the tile from where the blank is now if it moved
+    std::vector<int> path;
+    for (int state = found; came_by[state] != start_state;) {
+        int move = came_by[state], tile_cell = state / n, blank_cell = state % n;
+        int previous_blank = blank_cell - row_step[move] * box_width - column_step[move];
+        state = (tile_cell == previous_blank ? blank_cell : tile_cell) * n + previous_blank;
+        path.push_back(move);
+    }
+    for (auto move = path.rbegin(); move != path.rend(); ++move) slide(real_move(*move));
+    return true;
+}
+
+bool LargeBoardSolver::route_blank(int row_from, int row_to, int column_from, int column_to, int locked, int other_locked) {
+    auto inside = [&](int real_cell) {
+        int row = row_of(real_cell), column = column_of(real_cell);
+        return row >= row_from && row <= row_to && column >= column_from && column <= column_to;
+    };
+    if (inside(blank)) return true;
+
+    came_by.assign(board.size(), unvisited);
+    queue.clear();
+    came_by[blank] = start_state;
+    queue.push_back(blank);
+    int found = -1;
+    for (size_t head = 0; head < queue.size() && found < 0; head++) {
+        int current = queue[head], row = row_of(current), column = column_of(current);
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            int next_row = row + row_step[move], next_column = column + column_step[move];
+            if (next_row < top || next_row >= width || next_column < left || next_column >= width) continue;
+            int next = cell(next_row, next_column);
+            if (fixed[next] || next == locked || next == other_locked || came_by[next] != unvisited) continue;
+            came_by[next] = static_cast<uint8_t>(move);
+            if (inside(next)) {
+                found = next;
+                break;
+            }
+            queue.push_back(next);
+        }
+    }
+    if (found < 0) return false;
+
+    std::vector<int> path;
+    for (int current = found; came_by[current] != start_state;) {
+        int move = came_by[current];
+        path.push_back(move);
+        current = cell(row_of(current) - row_step[move], column_of(current) - column_step[move]);
+    }
+    for (auto move = path.rbegin(); move != path.rend(); ++move) slide(real_move(*move));
+    return true;
+}
+
+void LargeBoardSolver::finish_three_by_three() {
+    //// the bottom right 3x3 renumbered as an 8-puzzle, the tile of goal cell (r, c) becomes 3r + c + 1
+    int corner = width - EightPuzzleTable::width;
+    char small[EightPuzzleTable::tiles];
+    for (int row = 0; row < EightPuzzleTable::width; row++) {
+        for (int column = 0; column < EightPuzzleTable::width; column++) {
+            tile_type tile = board[(corner + row) * width + corner + column];
+            int home = tile - 1;
+            small[row * EightPuzzleTable::width + column] = tile == 0 ? 0
+                    : static_cast<char>((home / width - corner) * EightPuzzleTable::width + home % width - corner + 1);
+        }
+    }
+    MoveString finish = eight_table.solve(small).moves;
+    for (size_t i = 0; i < finish.size(); i++) slide(finish[i]);
+}
@@ -0,0 +1,96 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef LARGEBOARDSOLVER_H
+#define LARGEBOARDSOLVER_H
+#include <cstdint>
+#include <vector>
+#include "EightPuzzleTable.h"
+#include "MoveString.h"
+
+
+// Fast suboptimal solver for boards far beyond optimal search, 20x20 in
+// milliseconds. The board shrinks one row and one column at a time: the top
+// row of what is left is put in place tile by tile, then its left column, and
+// the last 3x3 is finished optimally through the EightPuzzleTable.
+//
+// A tile travels home in legs of up to leg_length rows and columns. Each leg
+// walks the blank up to the bounding box of the tile and the leg's end (one
+// cell of margin around) and runs an exact breadth-first search over (cell of
+// the tile, cell of the blank) inside that box, placed tiles walled off - the
+// fewest moves for that one tile, whatever the other loose tiles do. Short
+// legs keep the boxes small: the search costs the square of the box. Only if
+// the legs get stuck is the search rerun over the whole trip, then over
+// everything that is left.
+//
+// The last two tiles of a line cannot be placed one after the other: the
+// second steps two rows down, the first is parked in the line's last cell,
+// the second right below it, and the blank comes round to slide both in with
+// two moves. The column pass is the row pass on the transposed board, so one
+// line routine serves both.
+//
+// Tiles are 16-bit. The widths stop at max_width, where the fallback search
+// over a whole board would need 1M states; memory otherwise stays linear in
+// the board. With set_cancel_inverses() (the default) a move undone right
+// away by the next is dropped from the result.
+class LargeBoardSolver {
+public:
+    typedef uint16_t tile_type;
+    static constexpr int max_width = 32;
+    static constexpr int leg_length = 2;
+
+    // the table solves the final 3x3, it has to be open
+    explicit LargeBoardSolver(const EightPuzzleTable& _eight_table) : eight_table(_eight_table) {}
+
+    // throws std::invalid_argument for a width outside 3..max_width or a board
+    // that is not a permutation, std::runtime_error for an unsolvable one
+    MoveString solve(const tile_type* game_state, int _width);
+
+    void set_cancel_inverses(bool _cancel_inverses) { cancel_inverses = _cancel_inverses; }
+    // search states the placements went through
+    unsigned long long get_nodes_expanded() const { return nodes_expanded; }
+
+private:
+    const EightPuzzleTable& eight_table;
+    bool cancel_inverses = true;
+    unsigned long long nodes_expanded = 0;
+
+    //// the board being solved
+    int width = 0;
+    std::vector<tile_type> board;
+    std::vector<int> position; // tile -> cell
+    std::vector<uint8_t> fixed; // cells of placed tiles
+    int blank = 0;
+    MoveString moves;
+
+    //// the view the line routine works in: rows and columns swap when transposed,
+    //// the region left to solve is rows [top, width) x columns [left, width) of the view
+    bool transposed = false;
+    int top = 0, left = 0;
+
+    //// placement search, reused between placements
+    std::vector<uint8_t> came_by; // per (tile cell, blank cell) of the box, the move that got there
+    std::vector<int> queue;
+
+    int cell(int row, int column) const { return transposed ? column * width + row : row * width + column; }
+    int row_of(int real_cell) const { return transposed ? real_cell % width : real_cell / width; }
+    int column_of(int real_cell) const { return transposed ? real_cell / width : real_cell % width; }
+    int real_move(int move) const; // view move -> board move
+    tile_type goal_tile(int row, int column) const { return static_cast<tile_type>(cell(row, column) + 1); }
+
+    void slide(int move); // moves the blank on the board, recording the move
+    void solve_line(int line, int first);
+    // brings `tile` to the view cell (row, column) without touching fixed cells or `locked`
+    void place(tile_type tile, int row, int column, int locked);
+    // the search inside the bounding box of the tile and its real target cell, one cell of margin
+    bool place_box(tile_type tile, int target, int locked);
+    bool place_within(tile_type tile, int target, int locked, int row_from, int row_to, int column_from, int column_to);
+    // walks the blank into the view rectangle around fixed cells and the two
+    // locked ones (-1 for none), false when it cannot get there
+    bool route_blank(int row_from, int row_to, int column_from, int column_to, int locked, int other_locked);
+    void finish_three_by_three();
+};
+
+
+#endif //LARGEBOARDSOLVER_H
@@ -0,0 +1,110 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef LEGACYHEURISTICS_H
+#define LEGACYHEURISTICS_H
+#include <cstdlib>
+#include "Heuristics.h"
+#include "Inversions.h"
+
+
+// The estimates Solver started out with, kept value for value so old runs
+// can be reproduced, now for any board width. Only the first and the last
+// of them are admissible.
+
+// half the Manhattan distance
+template<int Width>
+class LegacyManhattan : public ScalarHeuristic {
+public:
+    static const char* name() { return "legacy_manhattan"; }
+    static constexpr bool is_admissible = true, is_consistent = true;
+
+    static int update(int, const char* game_state, char, int, int, int) { return evaluate(game_state); }
+
+    static int evaluate(const char* game_state) {
+        return Manhattan<Width>::evaluate(game_state) / 2;
+    }
+};
+
+// half the Manhattan distance plus 2 per out-of-order pair in a row, and per
+// column pair matching the original (chained) comparison
+template<int Width>
+class LegacyLinearConflict : public ScalarHeuristic {
+public:
+    static const char* name() { return "legacy_linear_conflict"; }
+    static constexpr bool is_admissible = false, is_consistent = false;
+
+    static int update(int, const char* game_state, char, int, int, int) { return evaluate(game_state); }
+
+    static int evaluate(const char* game_state) {
+        int sum = Manhattan<Width>::evaluate(game_state) / 2;
+        for (int row = 0; row < Width * Width; row += Width) {
+            for (int i = 0; i < Width; i++) {
+                for (int j = i + 1; j < Width; j++) {
+                    if (game_state[row + i] > game_state[row + j]) sum += 2;
+                }
+            }
+        }
+        for (int column = 0; column < Width; column++) {
+            for (int i = 0; i < Width * Width; i += Width) {
+                for (int j = i + Width; j < Width * Width; j += Width) {
+                    bool at_home = game_state[column + i] % Width == column;
+                    if (static_cast<int>(at_home) == game_state[column + j] % Width && game_state[column + i] > game_state[column + j]) sum += 2;
+                }
+            }
+        }
+        return sum;
+    }
+};
+
+// per tile 3 moves per row or column it is off, plus 2 when the blank sits on
+// the far side, halved - a mock of walking distance that overestimates
+template<int Width>
+class LegacyWalkingDistance : public ScalarHeuristic {
+public:
+    static const char* name() { return "legacy_walking_distance"; }
+    static constexpr bool is_admissible = false, is_consistent = false;
+
+    static int update(int, const char* game_state, char, int, int, int) { return evaluate(game_state); }
+
+    static int evaluate(const char* game_state) {
+        int blank = 0;
+        while (game_state[blank] != 0) blank++;
+        int blank_x = blank % Width, blank_y = blank / Width;
+        int sum = 0;
+        for (int i = 0; i < Width * Width; i++) {
+            if (i == blank) continue;
+            int x = i % Width, y = i / Width;
+            int home_x = (game_state[i] - 1) % Width, home_y = (game_state[i] - 1) / Width;
+            int vertical = std::abs(home_y - y), horizontal = std::abs(home_x - x);
+            if (vertical != 0) {
+                sum += vertical * 3;
+                if ((home_y - blank_y) * (home_y - y) < 0 && std::abs(home_y - blank_y) >= vertical) sum += 2;
+            }
+            if (horizontal != 0) {
+                sum += horizontal * 3;
+                if ((home_x - blank_x) * (home_x - x) > 0 && std::abs(home_x - blank_x) >= horizontal) sum += 2;
+            }
+        }
+        return sum / 2;
+    }
+};
+
+// inversions over the most a single move can undo (a vertical move jumps Width - 1 tiles)
+template<int Width>
+class InversionDistance : public ScalarHeuristic {
+public:
+    static const char* name() { return "inversion_distance"; }
+    static constexpr bool is_admissible = true, is_consistent = true;
+
+    static int update(int, const char* game_state, char, int, int, int) { return evaluate(game_state); }
+
+    static int evaluate(const char* game_state) {
+        long long inversions = Inversions::count(game_state, Width * Width);
+        return static_cast<int>((inversions + Width - 2) / (Width - 1));
+    }
+};
+
+
+#endif //LEGACYHEURISTICS_H
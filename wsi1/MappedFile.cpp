@@ -0,0 +1,71 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "MappedFile.h"
+#include <stdexcept>
+#include <fstream>
+#include <iterator>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define WSI_HAVE_MMAP 1
+#endif
+
+
+void MappedFile::open(const std::string& _path) {
+    close();
+    path = _path;
+    remap();
+}
+
+void MappedFile::remap() {
+    std::string keep = path;
+    close();
+    path = keep;
+
+#ifdef WSI_HAVE_MMAP
+    int descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor == -1) {
+        path.clear();
+        throw std::runtime_error("cannot open " + keep);
+    }
+    struct stat info{};
+    fstat(descriptor, &info);
+    length = static_cast<size_t>(info.st_size);
+    if (length > 0) {
+        void* address = mmap(nullptr, length, PROT_READ, MAP_SHARED, descriptor, 0);
+        if (address == MAP_FAILED) {
+            ::close(descriptor);
+            path.clear();
+            throw std::runtime_error("cannot map " + keep);
+        }
+        bytes = static_cast<const unsigned char*>(address);
+        mapped = true;
+    }
+    ::close(descriptor);
+#else
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        path.clear();
+        throw std::runtime_error("cannot open " + keep);
+    }
+    fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    bytes = fallback.data();
+    length = fallback.size();
+#endif
+}
+
+void MappedFile::close() {
+#ifdef WSI_HAVE_MMAP
+    if (mapped) munmap(const_cast<unsigned char*>(bytes), length);
+#endif
+    std::vector<unsigned char>().swap(fallback);
+    bytes = nullptr;
+    length = 0;
+    mapped = false;
+    path.clear();
+}
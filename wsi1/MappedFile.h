@@ -0,0 +1,40 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <string>
+#include <vector>
+#include <cstddef>
+
+
+// Read-only view of a whole file. Memory-mapped where mmap is available, so
+// large tables are paged in lazily and shared between solver processes;
+// elsewhere the file is simply read into memory.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    void open(const std::string& path); // throws std::runtime_error when the file can't be opened
+    void remap();                       // picks up data appended to the file since open()
+    void close();
+
+    const unsigned char* data() const { return bytes; }
+    size_t size() const { return length; }
+    bool is_open() const { return !path.empty(); }
+
+private:
+    std::string path;
+    const unsigned char* bytes = nullptr;
+    size_t length = 0;
+    bool mapped = false;
+    std::vector<unsigned char> fallback;
+};
+
+
+#endif //MAPPEDFILE_H
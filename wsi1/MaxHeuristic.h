@@ -0,0 +1,142 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef MAXHEURISTIC_H
+#define MAXHEURISTIC_H
+#include <algorithm>
+#include <climits>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Heuristics.h"
+#include "PatternDatabase.h"
+#include "Symmetry.h"
+
+
+// The maximum of a set of admissible heuristics, put together at runtime from
+// a spec such as
+//   "walking_distance,linear_conflict,pdb:7-8.pdb,pdb_reflected:7-8.pdb,pdb_dual:7-8.pdb"
+// pdb looks the board up as it is, pdb_reflected looks up its mirror across
+// the main diagonal and pdb_dual its inverse permutation, each file is loaded
+// once. The dual takes as many moves as the board itself only with the blank
+// at home, so the dual lookup first walks the blank home (right, then down)
+// and subtracts the moves that took.
+// Components run cheapest first and evaluation stops as soon as the maximum
+// exceeds the caller's limit - the node gets cut off either way.
+template<int Width>
+class MaxHeuristic {
+public:
+    typedef int value_type;
+    static const char* name() { return "max"; }
+    static constexpr bool is_admissible = true, is_consistent = false;
+
+    explicit MaxHeuristic(const std::string& spec) {
+        std::stringstream items(spec);
+        std::string item;
+        while (std::getline(items, item, ',')) {
+            if (item.empty()) continue;
+            std::string name = item.substr(0, item.find(':'));
+            std::string path = item.find(':') == std::string::npos ? "" : item.substr(item.find(':') + 1);
+            add(name, path);
+        }
+        if (components.empty()) {
+            throw std::invalid_argument("heuristic spec " + spec + " names no heuristic");
+        }
+        std::stable_sort(components.begin(), components.end(),
+                         [](const Component& a, const Component& b) { return a.type < b.type; });
+    }
+
+    int evaluate(const char* game_state, int limit) const {
+        int value = 0;
+        for (const auto& component : components) {
+            value = std::max(value, evaluate(component, game_state));
+            if (value > limit) break;
+        }
+        return value;
+    }
+
+    value_type evaluate(const char* game_state) const { return evaluate(game_state, INT_MAX); }
+
+    value_type update(const value_type&, const char* game_state, char, int, int, int limit) const {
+        return evaluate(game_state, limit);
+    }
+
+    static int cost(const value_type& value) { return value; }
+
+    // the components in the order they are evaluated
+    std::string describe() const {
+        std::string result;
+        for (const auto& component : components) {
+            if (!result.empty()) result += ",";
+            result += component.name;
+        }
+        return result;
+    }
+
+private:
+    // declared cheapest first, the evaluation order
+    enum kind { manhattan, linear_conflict, walking_distance, pdb, pdb_reflected, pdb_dual };
+
+    struct Component {
+        kind type;
+        std::string name;
+        const PatternDatabase* database;
+    };
+
+    std::vector<Component> components;
+    std::map<std::string, std::unique_ptr<PatternDatabase>> databases;
+
+    void add(const std::string& name, const std::string& path) {
+        static const std::map<std::string, kind> kinds = {
+                {"manhattan", manhattan}, {"linear_conflict", linear_conflict}, {"walking_distance", walking_distance},
+                {"pdb", pdb}, {"pdb_reflected", pdb_reflected}, {"pdb_dual", pdb_dual}};
+        auto found = kinds.find(name);
+        if (found == kinds.end()) {
+            throw std::invalid_argument("unknown heuristic " + name);
+        }
+        const PatternDatabase* database = nullptr;
+        if (found->second >= pdb) {
+            if (path.empty()) throw std::invalid_argument(name + " needs a database file, " + name + ":FILE");
+            auto& loaded = databases[path];
+            if (!loaded) {
+                loaded.reset(new PatternDatabase(path));
+                if (loaded->get_width() != Width) throw std::invalid_argument(path + " is for another board width");
+            }
+            database = loaded.get();
+        }
+        components.push_back(Component{found->second, path.empty() ? name : name + ":" + path, database});
+    }
+
+    static int evaluate(const Component& component, const char* game_state) {
+        char transformed[Width * Width];
+        switch (component.type) {
+            case manhattan: return Manhattan<Width>::evaluate(game_state);
+            case linear_conflict: return LinearConflict<Width>::evaluate(game_state);
+            case walking_distance: return WalkingDistance<Width>::evaluate(game_state);
+            case pdb: return component.database->evaluate(game_state);
+            case pdb_reflected:
+                Symmetry::mirror(game_state, transformed, Width);
+                return component.database->evaluate(transformed);
+            default: {
+                char homed[Width * Width];
+                std::copy(game_state, game_state + Width * Width, homed);
+                int blank = static_cast<int>(std::find(homed, homed + Width * Width, 0) - homed);
+                if (blank == Width * Width) return 0;
+                int x = blank % Width, y = blank / Width;
+                int detour = (Width - 1 - x) + (Width - 1 - y);
+                for (int column = x; column < Width - 1; column++) homed[y * Width + column] = homed[y * Width + column + 1];
+                for (int row = y; row < Width - 1; row++) homed[row * Width + Width - 1] = homed[(row + 1) * Width + Width - 1];
+                homed[Width * Width - 1] = 0;
+                Symmetry::dual(homed, transformed, Width);
+                return std::max(0, component.database->evaluate(transformed) - detour);
+            }
+        }
+    }
+};
+
+
+#endif //MAXHEURISTIC_H
@@ -0,0 +1,152 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "MovePruning.h"
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+
+MovePruning::MovePruning(int _max_length) : max_length(_max_length) {
+    if (max_length < 1 || max_length > 16) {
+        throw std::invalid_argument("move pruning length must be within 1..16, not " + std::to_string(max_length));
+    }
+    find_redundant();
+    build_automaton();
+}
+
+const MovePruning& MovePruning::inverse_moves() {
+    static const MovePruning machine(2);
+    return machine;
+}
+
+const MovePruning& MovePruning::standard() {
+    static const MovePruning machine(default_length);
+    return machine;
+}
+
+// sequences are packed 2 bits per move, the first move in the lowest bits
+void MovePruning::find_redundant() {
+    const int grid = 2 * max_length + 1, origin = max_length * grid + max_length;
+    const int offsets[4] = {-grid, grid, -1, 1};
+    std::vector<int16_t> contents(static_cast<size_t>(grid) * grid); // which cell's tile a cell holds, -1 the blank
+    for (int cell = 0; cell < grid * grid; cell++) contents[cell] = static_cast<int16_t>(cell);
+    contents[origin] = -1;
+
+    // what a sequence leaves behind -> the visited cells of every kept sequence that does so
+    std::unordered_map<std::string, std::vector<std::vector<int16_t>>> kept;
+    std::unordered_set<uint64_t> redundant_codes; // length << 32 | moves
+    std::vector<uint32_t> level = {0};
+
+    auto replay = [&](uint32_t moves, int length, std::string& key, std::vector<int16_t>& visited) {
+        visited.assign(1, static_cast<int16_t>(origin));
+        int blank = origin;
+        for (int i = 0; i < length; i++) {
+            int destination = blank + offsets[(moves >> (2 * i)) & 3];
+            std::swap(contents[blank], contents[destination]);
+            blank = destination;
+            visited.push_back(static_cast<int16_t>(blank));
+        }
+        std::sort(visited.begin(), visited.end());
+        visited.erase(std::unique(visited.begin(), visited.end()), visited.end());
+        key.clear();
+        for (int16_t cell : visited) {
+            int16_t initial = cell == origin ? static_cast<int16_t>(-1) : cell;
+            if (contents[cell] == initial) continue;
+            key.append(reinterpret_cast<const char*>(&cell), sizeof(cell));
+            key.append(reinterpret_cast<const char*>(&contents[cell]), sizeof(int16_t));
+        }
+        for (int16_t cell : visited) contents[cell] = cell == origin ? static_cast<int16_t>(-1) : cell;
+    };
+
+    std::string key;
+    std::vector<int16_t> visited;
+    replay(0, 0, key, visited);
+    kept[key].push_back(visited);
+
+    for (int length = 1; length <= max_length; length++) {
+        std::vector<uint32_t> next_level;
+        for (uint32_t prefix : level) {
+            for (uint32_t move = 0; move < 4; move++) {
+                uint32_t moves = prefix | move << (2 * (length - 1));
+                //// anything ending in a redundant sequence is never generated
+                bool covered = false;
+                for (int suffix = 2; suffix < length && !covered; suffix++) {
+                    uint32_t tail = moves >> (2 * (length - suffix));
+                    covered = redundant_codes.count(static_cast<uint64_t>(suffix) << 32 | tail) != 0;
+                }
+                if (covered) continue;
+
+                replay(moves, length, key, visited);
+                auto& replacements = kept[key];
+                bool duplicate = std::any_of(replacements.begin(), replacements.end(), [&](const std::vector<int16_t>& cells) {
+                    return std::includes(visited.begin(), visited.end(), cells.begin(), cells.end());
+                });
+                if (duplicate) {
+                    redundant_codes.insert(static_cast<uint64_t>(length) << 32 | moves);
+                    MoveString sequence;
+                    for (int i = 0; i < length; i++) sequence.push_back(static_cast<int>((moves >> (2 * i)) & 3));
+                    redundant.push_back(sequence);
+                    continue;
+                }
+                replacements.push_back(visited);
+                if (length < max_length) next_level.push_back(moves);
+            }
+        }
+        level.swap(next_level);
+    }
+}
+
+// Aho-Corasick over the redundant sequences; a state that would complete one
+// of them (as a whole or as a suffix) is left out and its moves lead to `pruned`
+void MovePruning::build_automaton() {
+    std::vector<std::array<int32_t, 4>> children(1, {-1, -1, -1, -1});
+    std::vector<bool> terminal(1, false);
+    for (const auto& sequence : redundant) {
+        int node = 0;
+        for (size_t i = 0; i < sequence.size(); i++) {
+            int move = sequence[i];
+            if (children[node][move] < 0) {
+                children[node][move] = static_cast<int32_t>(children.size());
+                children.push_back({-1, -1, -1, -1});
+                terminal.push_back(false);
+            }
+            node = children[node][move];
+        }
+        terminal[node] = true;
+    }
+
+    //// breadth-first: failure links, full transitions and which states complete a pattern
+    std::vector<int32_t> failure(children.size(), 0), order = {0};
+    std::vector<std::array<int32_t, 4>> go(children.size());
+    for (size_t head = 0; head < order.size(); head++) {
+        int node = order[head];
+        if (terminal[failure[node]]) terminal[node] = true;
+        for (int move = 0; move < 4; move++) {
+            int child = children[node][move];
+            if (child < 0) {
+                go[node][move] = node == 0 ? 0 : go[failure[node]][move];
+                continue;
+            }
+            go[node][move] = child;
+            failure[child] = node == 0 ? 0 : go[failure[node]][move];
+            order.push_back(child);
+        }
+    }
+
+    //// renumber the live states in breadth-first order, the root stays 0
+    std::vector<int32_t> number(children.size(), pruned);
+    int32_t live = 0;
+    for (int node : order) {
+        if (!terminal[node]) number[node] = live++;
+    }
+    transitions.assign(static_cast<size_t>(live) * 4, pruned);
+    for (int node : order) {
+        if (terminal[node]) continue;
+        for (int move = 0; move < 4; move++) transitions[number[node] * 4 + move] = number[go[node][move]];
+    }
+}
@@ -0,0 +1,55 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef MOVEPRUNING_H
+#define MOVEPRUNING_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MoveString.h"
+
+
+// Duplicate pruning for depth-first search: a finite-state machine over the
+// moves of the blank that rejects every move sequence some other sequence
+// already covers.
+//
+// The machine is built by breadth-first search over the sequences of up to
+// max_length moves on an infinite grid, in length then move-code order. A
+// sequence is redundant when an earlier kept one leaves the same tiles in the
+// same cells and the blank on the same cell while visiting only cells the
+// sequence itself visits - so wherever the redundant one stays on the board,
+// the replacement does as well, whatever the board's width. The redundant
+// sequences become the patterns of an Aho-Corasick automaton: a search keeps
+// one state per node and never completes any of them. Length 2 gives back
+// the plain "no immediate inverse" rule.
+class MovePruning {
+public:
+    static constexpr int start = 0; // the state of the root, before any move
+    static constexpr int pruned = -1;
+    static constexpr int default_length = 10; // 1073 states, built in a fraction of a second
+
+    explicit MovePruning(int max_length = default_length);
+
+    // the state after `move`, or pruned when the move completes a redundant sequence
+    int next(int state, int move) const { return transitions[state * 4 + move]; }
+
+    int get_max_length() const { return max_length; }
+    size_t states() const { return transitions.size() / 4; }
+    const std::vector<MoveString>& get_redundant() const { return redundant; }
+
+    // shared machines, built at first use
+    static const MovePruning& inverse_moves(); // length 2
+    static const MovePruning& standard(); // default_length
+
+private:
+    int max_length;
+    std::vector<MoveString> redundant;
+    std::vector<int32_t> transitions;
+
+    void find_redundant();
+    void build_automaton();
+};
+
+
+#endif //MOVEPRUNING_H
@@ -0,0 +1,91 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "MoveString.h"
+#include <stdexcept>
+
+
+int MoveString::from_letter(char letter) {
+    switch (letter) {
+        case 'U': return up;
+        case 'D': return down;
+        case 'L': return left;
+        case 'R': return right;
+        default: throw std::invalid_argument(std::string("unknown move ") + letter);
+    }
+}
+
+int MoveString::offset(int move, int width) {
+    switch (move) {
+        case up: return -width;
+        case down: return width;
+        case left: return -1;
+        default: return 1;
+    }
+}
+
+int MoveString::from_offset(int offset, int width) {
+    if (offset == -width) return up;
+    if (offset == width) return down;
+    if (offset == -1) return left;
+    if (offset == 1) return right;
+    throw std::invalid_argument("blank offset " + std::to_string(offset) + " is not a single move");
+}
+
+int MoveString::apply(char* game_state, int width, int blank, int move) {
+    int x = blank % width, y = blank / width;
+    if ((move == up && y == 0) || (move == down && y == width - 1)
+        || (move == left && x == 0) || (move == right && x == width - 1)) {
+        throw std::invalid_argument("move leaves the board");
+    }
+    int destination = blank + offset(move, width);
+    game_state[blank] = game_state[destination];
+    game_state[destination] = 0;
+    return destination;
+}
+
+void MoveString::push_back(int move) {
+    if (length % 4 == 0) packed.push_back(0);
+    packed[length / 4] |= static_cast<unsigned char>((move & 3) << (2 * (length % 4)));
+    length++;
+}
+
+void MoveString::pop_back() {
+    if (length == 0) return;
+    length--;
+    packed[length / 4] &= static_cast<unsigned char>(~(3 << (2 * (length % 4))));
+    if (length % 4 == 0) packed.pop_back();
+}
+
+void MoveString::append(const MoveString& other) {
+    for (size_t i = 0; i < other.size(); i++) push_back(other[i]);
+}
+
+void MoveString::reverse() {
+    MoveString reversed;
+    for (size_t i = length; i > 0; i--) reversed.push_back(operator[](i - 1));
+    *this = reversed;
+}
+
+std::string MoveString::to_string() const {
+    std::string letters(length, ' ');
+    for (size_t i = 0; i < length; i++) letters[i] = letter(operator[](i));
+    return letters;
+}
+
+MoveString MoveString::from_string(const std::string& letters) {
+    MoveString moves;
+    for (char c : letters) moves.push_back(from_letter(c));
+    return moves;
+}
+
+MoveString MoveString::from_bytes(const unsigned char* bytes, size_t length) {
+    MoveString moves;
+    moves.packed.assign(bytes, bytes + (length + 3) / 4);
+    moves.length = length;
+    if (length % 4 != 0) {
+        moves.packed.back() &= static_cast<unsigned char>((1 << (2 * (length % 4))) - 1);
+    }
+    return moves;
+}
@@ -0,0 +1,54 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef MOVESTRING_H
+#define MOVESTRING_H
+#include <string>
+#include <vector>
+#include <cstddef>
+
+
+// A path through the game graph stored as the directions the blank travels,
+// 2 bits per move (4 moves per byte, lowest bits first). The codes follow the
+// order of Solver::Node::all_directions, so the inverse of a move is code ^ 1.
+class MoveString {
+public:
+    enum code : unsigned char {
+        up = 0,
+        down = 1,
+        left = 2,
+        right = 3
+    };
+
+    static int inverse(int move) { return move ^ 1; }
+    static char letter(int move) { return "UDLR"[move & 3]; }
+    static int from_letter(char letter);
+    static int offset(int move, int width); // index difference of the blank for the given board width
+    static int from_offset(int offset, int width);
+    // moves the blank of a width x width board, returns the new blank index
+    static int apply(char* game_state, int width, int blank, int move);
+
+    void push_back(int move);
+    void pop_back();
+    int operator[](size_t i) const { return (packed[i / 4] >> (2 * (i % 4))) & 3; }
+    size_t size() const { return length; }
+    bool empty() const { return length == 0; }
+    void clear() { packed.clear(); length = 0; }
+    void append(const MoveString& other);
+    void reverse();
+    bool operator==(const MoveString& other) const { return length == other.length && packed == other.packed; }
+
+    std::string to_string() const;
+    static MoveString from_string(const std::string& letters); // throws std::invalid_argument on unknown letters
+
+    const std::vector<unsigned char>& bytes() const { return packed; }
+    static MoveString from_bytes(const unsigned char* bytes, size_t length);
+
+private:
+    std::vector<unsigned char> packed;
+    size_t length = 0;
+};
+
+
+#endif //MOVESTRING_H
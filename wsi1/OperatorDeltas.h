@@ -0,0 +1,91 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef OPERATORDELTAS_H
+#define OPERATORDELTAS_H
+#include <climits>
+#include <cstdint>
+#include <vector>
+#include "Heuristics.h"
+#include "MoveString.h"
+
+
+// Enhanced partial expansion (EPEA*) picks the children of a node by their f
+// before building any of them, so it asks for the estimate after every move
+// of the blank up front. children() fills estimates[move] (indexed by move
+// code, -1 where the blank would leave the board) and leaves the board as it
+// found it.
+
+template<int Width>
+inline bool blank_can_move(int blank, int move) {
+    int x = blank % Width, y = blank / Width;
+    return !((move == MoveString::up && y == 0) || (move == MoveString::down && y == Width - 1)
+             || (move == MoveString::left && x == 0) || (move == MoveString::right && x == Width - 1));
+}
+
+// by default the parent is evaluated once and every move is an update() of
+// it: for pattern databases one lookup of the pattern the slid tile belongs to
+template<int Width, class Heuristic>
+struct OperatorDeltas {
+    static void children(const Heuristic& estimator, char* game_state, int blank, int, int estimates[4]) {
+        auto value = estimator.evaluate(game_state);
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if (!blank_can_move<Width>(blank, move)) {
+                estimates[move] = -1;
+                continue;
+            }
+            int from = blank + MoveString::offset(move, Width);
+            char tile = game_state[from];
+            game_state[blank] = tile;
+            game_state[from] = 0;
+            estimates[move] = Heuristic::cost(estimator.update(value, game_state, tile, from, blank, INT_MAX));
+            game_state[from] = tile;
+            game_state[blank] = 0;
+        }
+    }
+};
+
+// Manhattan: the change only depends on the tile, where the blank is and the
+// move, a table of them built at first use needs neither the board copy nor
+// an evaluation
+template<int Width>
+struct OperatorDeltas<Width, Manhattan<Width>> {
+    static void children(const Manhattan<Width>&, char* game_state, int blank, int h, int estimates[4]) {
+        const auto& table = deltas();
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if (!blank_can_move<Width>(blank, move)) {
+                estimates[move] = -1;
+                continue;
+            }
+            int tile = game_state[blank + MoveString::offset(move, Width)];
+            estimates[move] = h + table[(tile * cells + blank) * 4 + move];
+        }
+    }
+
+private:
+    static const int cells = Width * Width;
+
+    static const std::vector<int8_t>& deltas() {
+        static const std::vector<int8_t> table = build();
+        return table;
+    }
+
+    // [tile][blank][move]: the tile next to the blank in the move's direction slides into the blank
+    static std::vector<int8_t> build() {
+        std::vector<int8_t> table(static_cast<size_t>(cells) * cells * 4, 0);
+        for (int tile = 1; tile < cells; tile++) {
+            for (int blank = 0; blank < cells; blank++) {
+                for (int move = MoveString::up; move <= MoveString::right; move++) {
+                    if (!blank_can_move<Width>(blank, move)) continue;
+                    int from = blank + MoveString::offset(move, Width);
+                    table[(tile * cells + blank) * 4 + move] = static_cast<int8_t>(Manhattan<Width>::update(0, nullptr, static_cast<char>(tile), from, blank, INT_MAX));
+                }
+            }
+        }
+        return table;
+    }
+};
+
+
+#endif //OPERATORDELTAS_H
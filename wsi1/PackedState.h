@@ -0,0 +1,70 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef PACKEDSTATE_H
+#define PACKEDSTATE_H
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+// squeezes a Width x Width board into a single integer so that large sets of
+// states can be sorted, hashed and written to disk without the Node overhead.
+// Boards up to 4x4 take 4 bits per tile in a uint64_t (tile at index i is kept
+// in bits [4i, 4i + 4)), a 5x5 board takes 5 bits per tile, 125 bits in an
+// unsigned __int128.
+template<int Width>
+class PackedState {
+public:
+    static const int tiles = Width * Width;
+    static const int bits_per_tile = tiles <= 16 ? 4 : 5;
+    typedef typename std::conditional<tiles * bits_per_tile <= 64, uint64_t, unsigned __int128>::type type;
+    static constexpr type tile_mask = (type(1) << bits_per_tile) - 1;
+
+    static_assert(tiles * bits_per_tile <= 128, "board does not fit into 128 bits");
+
+    // folds both halves of a 128-bit state, for unordered containers
+    struct hash {
+        size_t operator()(type packed) const {
+            uint64_t folded = static_cast<uint64_t>(packed) ^ static_cast<uint64_t>(packed >> 32 >> 32) * 0x9E3779B97F4A7C15ULL;
+            return static_cast<size_t>(folded ^ (folded >> 29));
+        }
+    };
+
+    static type pack(const char* game_state) {
+        type packed = 0;
+        for (int i = 0; i < tiles; i++) {
+            packed |= static_cast<type>(game_state[i]) << (i * bits_per_tile);
+        }
+        return packed;
+    }
+
+    static void unpack(type packed, char* game_state) {
+        for (int i = 0; i < tiles; i++) {
+            game_state[i] = static_cast<char>((packed >> (i * bits_per_tile)) & tile_mask);
+        }
+    }
+
+    static int tile_at(type packed, int index) {
+        return static_cast<int>((packed >> (index * bits_per_tile)) & tile_mask);
+    }
+
+    static int find_blank(type packed) {
+        for (int i = 0; i < tiles; i++) {
+            if (tile_at(packed, i) == 0)
+                return i;
+        }
+        return -1;
+    }
+
+    // slides the tile standing at destination onto the blank at current
+    static type move_blank(type packed, int current, int destination) {
+        type tile = (packed >> (destination * bits_per_tile)) & tile_mask;
+        packed &= ~(tile_mask << (destination * bits_per_tile));
+        return packed | (tile << (current * bits_per_tile));
+    }
+};
+
+
+#endif //PACKEDSTATE_H
@@ -0,0 +1,158 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef PARALLELIDASTAR_H
+#define PARALLELIDASTAR_H
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "IdaStar.h"
+
+
+// IDA* with every iteration split at the root: a breadth-first search first
+// lays out the nodes a few moves deep (at least `splits_per_thread` of them
+// per thread), then the threads take them one by one and run the iteration
+// below each with their own IdaStar. They all share the transposition table,
+// and the first to reach the goal stops the others - any solution found
+// within the bound is as short as the bound, so it is optimal as well.
+template<int Width, class Heuristic>
+class ParallelIdaStar {
+public:
+    static constexpr int cells = Width * Width;
+    static constexpr size_t splits_per_thread = 16;
+
+    ParallelIdaStar(const Heuristic& _heuristic, int _threads, TranspositionTable* _table = nullptr,
+                    const MovePruning& _pruning = MovePruning::inverse_moves())
+            : heuristic(_heuristic), threads(std::max(_threads, 1)), table(_table), pruning(_pruning) {}
+
+    // throws std::runtime_error for a permutation that cannot reach the goal
+    Solution solve(const char* game_state) {
+        if (!IdaStar<Width, Heuristic>::is_solvable(game_state)) {
+            throw std::runtime_error("given starting permutation is not solvable!\n");
+        }
+        Solution solution(game_state, Width);
+        nodes_expanded = 0;
+        if (table != nullptr) table->new_generation();
+
+        std::vector<Split> splits;
+        if (lay_out(game_state, splits, solution.moves)) {
+            solution.nodes_expanded = nodes_expanded;
+            return solution;
+        }
+
+        std::vector<std::unique_ptr<IdaStar<Width, Heuristic>>> workers;
+        std::atomic<bool> stop(false);
+        for (int i = 0; i < threads; i++) {
+            workers.emplace_back(new IdaStar<Width, Heuristic>(heuristic, pruning));
+            workers.back()->use_table(table);
+            workers.back()->use_perimeter(perimeter);
+            workers.back()->use_stop_flag(&stop);
+        }
+
+        int bound = Heuristic::cost(heuristic.evaluate(game_state));
+        while (true) {
+            std::atomic<size_t> next_split(0);
+            std::mutex guard;
+            int next_bound = INT_MAX;
+            bool solved = false;
+
+            auto work = [&](IdaStar<Width, Heuristic>& worker) {
+                int smallest = INT_MAX;
+                for (size_t i = next_split++; i < splits.size() && !stop.load(); i = next_split++) {
+                    const Split& split = splits[i];
+                    int t = worker.iterate(split.board.data(), split.g, bound, split.state);
+                    if (t == IdaStar<Width, Heuristic>::found) {
+                        std::lock_guard<std::mutex> lock(guard);
+                        if (!solved) {
+                            solved = true;
+                            solution.moves = split.moves;
+                            solution.moves.append(worker.get_path());
+                        }
+                        stop = true;
+                        break;
+                    }
+                    smallest = std::min(smallest, t);
+                }
+                std::lock_guard<std::mutex> lock(guard);
+                next_bound = std::min(next_bound, smallest);
+            };
+
+            std::vector<std::thread> pool;
+            for (int i = 1; i < threads; i++) pool.emplace_back(work, std::ref(*workers[i]));
+            work(*workers[0]);
+            for (auto& thread : pool) thread.join();
+
+            if (solved) break;
+            if (next_bound == INT_MAX) throw std::runtime_error("search space exhausted without reaching the goal");
+            bound = next_bound;
+        }
+        for (const auto& worker : workers) nodes_expanded += worker->get_nodes_expanded();
+        solution.nodes_expanded = nodes_expanded;
+        return solution;
+    }
+
+    unsigned long long get_nodes_expanded() const { return nodes_expanded; }
+    // shared by the workers, see IdaStar::use_perimeter()
+    void use_perimeter(const EndgameTable* _perimeter) { perimeter = _perimeter; }
+
+private:
+    struct Split {
+        std::vector<char> board;
+        int g;
+        int state;
+        MoveString moves;
+    };
+
+    const Heuristic& heuristic;
+    int threads;
+    TranspositionTable* table;
+    const EndgameTable* perimeter = nullptr;
+    const MovePruning& pruning;
+    unsigned long long nodes_expanded = 0;
+
+    static bool is_goal(const char* game_state) {
+        for (int i = 0; i < cells - 1; i++) {
+            if (game_state[i] != i + 1) return false;
+        }
+        return true;
+    }
+
+    // level by level until there are enough nodes; true (with the moves) when
+    // the goal turns up first, breadth-first it is the shortest way there
+    bool lay_out(const char* game_state, std::vector<Split>& splits, MoveString& moves) {
+        splits.assign(1, Split{std::vector<char>(game_state, game_state + cells), 0, MovePruning::start, MoveString()});
+        for (int depth = 0; splits.size() < splits_per_thread * static_cast<size_t>(threads); depth++) {
+            std::vector<Split> next;
+            for (const auto& split : splits) {
+                if (is_goal(split.board.data())) {
+                    moves = split.moves;
+                    return true;
+                }
+                nodes_expanded++;
+                int blank = static_cast<int>(std::find(split.board.begin(), split.board.end(), 0) - split.board.begin());
+                int x = blank % Width, y = blank / Width;
+                for (int move = MoveString::up; move <= MoveString::right; move++) {
+                    int state = pruning.next(split.state, move);
+                    if (state == MovePruning::pruned) continue;
+                    if ((move == MoveString::up && y == 0) || (move == MoveString::down && y == Width - 1)
+                        || (move == MoveString::left && x == 0) || (move == MoveString::right && x == Width - 1)) continue;
+                    Split child{split.board, depth + 1, state, split.moves};
+                    MoveString::apply(child.board.data(), Width, blank, move);
+                    child.moves.push_back(move);
+                    next.push_back(std::move(child));
+                }
+            }
+            splits.swap(next);
+        }
+        return false;
+    }
+};
+
+
+#endif //PARALLELIDASTAR_H
@@ -0,0 +1,251 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "PathOptimizer.h"
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdlib>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+typedef std::chrono::steady_clock clock_type;
+
+
+// splitmix64's finalizer, spreads (tile, cell) over all 64 bits
+static uint64_t mix(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t placement(int tile, int cell) {
+    return mix((static_cast<uint64_t>(tile) << 32) | static_cast<uint64_t>(cell));
+}
+
+// moves the blank, returns its new cell; throws std::invalid_argument when it would leave the board
+static int slide(std::vector<PathOptimizer::tile_type>& board, int width, int blank, int move) {
+    int x = blank % width, y = blank / width;
+    if ((move == MoveString::up && y == 0) || (move == MoveString::down && y == width - 1)
+        || (move == MoveString::left && x == 0) || (move == MoveString::right && x == width - 1)) {
+        throw std::invalid_argument("move leaves the board");
+    }
+    int destination = blank + MoveString::offset(move, width);
+    board[blank] = board[destination];
+    board[destination] = 0;
+    return destination;
+}
+
+static int find_blank(const std::vector<PathOptimizer::tile_type>& board) {
+    return static_cast<int>(std::find(board.begin(), board.end(), 0) - board.begin());
+}
+
+static std::vector<PathOptimizer::tile_type> replay(std::vector<PathOptimizer::tile_type> board, int width, const MoveString& moves) {
+    int blank = find_blank(board);
+    for (size_t i = 0; i < moves.size(); i++) blank = slide(board, width, blank, moves[i]);
+    return board;
+}
+
+
+// IDA* from one board to another with the Manhattan distance between them
+class WindowSearch {
+public:
+    static constexpr int found = -1;
+
+    WindowSearch(int _width, const std::vector<PathOptimizer::tile_type>& from, const std::vector<PathOptimizer::tile_type>& to,
+                 clock_type::time_point _deadline)
+            : width(_width), board(from), target_row(to.size()), target_column(to.size()), deadline(_deadline) {
+        for (size_t cell = 0; cell < to.size(); cell++) {
+            target_row[to[cell]] = static_cast<int>(cell) / width;
+            target_column[to[cell]] = static_cast<int>(cell) % width;
+        }
+        blank = find_blank(board);
+    }
+
+    // a way shorter than `limit` moves into path, false when there is none (or the time ran out)
+    bool solve(int limit, MoveString& result) {
+        int h = 0;
+        for (int cell = 0; cell < static_cast<int>(board.size()); cell++) {
+            if (board[cell] != 0) h += distance(board[cell], cell);
+        }
+        for (int bound = h; bound < limit;) {
+            int t = search(0, bound, h, -1);
+            if (t == found) {
+                result = path;
+                return true;
+            }
+            if (t == INT_MAX) return false;
+            bound = t;
+        }
+        return false;
+    }
+
+    unsigned long long get_nodes_expanded() const { return nodes_expanded; }
+
+private:
+    int width;
+    std::vector<PathOptimizer::tile_type> board;
+    std::vector<int> target_row, target_column;
+    int blank;
+    clock_type::time_point deadline;
+    MoveString path;
+    unsigned long long nodes_expanded = 0;
+
+    int distance(int tile, int cell) const {
+        return std::abs(cell / width - target_row[tile]) + std::abs(cell % width - target_column[tile]);
+    }
+
+    // h == 0 puts every tile on its target cell, the blank takes the one left over
+    int search(int g, int bound, int h, int previous) {
+        if (g + h > bound) return g + h;
+        if (h == 0) return found;
+        if ((++nodes_expanded & 4095) == 0 && clock_type::now() > deadline) return INT_MAX;
+
+        int next_bound = INT_MAX, x = blank % width, y = blank / width;
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if ((previous >= 0 && move == MoveString::inverse(previous)) || (move == MoveString::up && y == 0)
+                || (move == MoveString::down && y == width - 1) || (move == MoveString::left && x == 0)
+                || (move == MoveString::right && x == width - 1)) continue;
+            int from = blank, destination = blank + MoveString::offset(move, width);
+            PathOptimizer::tile_type tile = board[destination];
+            int child_h = h - distance(tile, destination) + distance(tile, from);
+            board[from] = tile;
+            board[destination] = 0;
+            blank = destination;
+            path.push_back(move);
+
+            int t = search(g + 1, bound, child_h, move);
+            if (t == found) return found;
+            path.pop_back();
+            board[destination] = tile;
+            board[from] = 0;
+            blank = from;
+            if (t == INT_MAX && clock_type::now() > deadline) return INT_MAX;
+            next_bound = std::min(next_bound, t);
+        }
+        return next_bound;
+    }
+};
+
+
+PathOptimizer::PathOptimizer(int _window_length, int _threads) : window_length(_window_length), threads(std::max(_threads, 1)) {
+    if (window_length < 2) throw std::invalid_argument("optimization windows need at least 2 moves");
+}
+
+MoveString PathOptimizer::cancel_inverses(const MoveString& moves) {
+    MoveString kept;
+    for (size_t i = 0; i < moves.size(); i++) {
+        if (!kept.empty() && kept[kept.size() - 1] == MoveString::inverse(moves[i])) kept.pop_back();
+        else kept.push_back(moves[i]);
+    }
+    return kept;
+}
+
+MoveString PathOptimizer::remove_loops(const std::vector<tile_type>& start, int width, const MoveString& moves) {
+    std::vector<tile_type> board = start;
+    int blank = find_blank(board);
+    uint64_t hash = 0;
+    for (int cell = 0; cell < static_cast<int>(board.size()); cell++) hash += placement(board[cell], cell);
+
+    //// hashes[i] is the board after the first i kept moves, first_visit finds them back
+    MoveString kept;
+    std::vector<uint64_t> hashes = {hash};
+    std::unordered_map<uint64_t, size_t> first_visit = {{hash, 0}};
+    for (size_t i = 0; i < moves.size(); i++) {
+        int destination = slide(board, width, blank, moves[i]);
+        tile_type tile = board[blank];
+        hash += placement(tile, blank) - placement(tile, destination) + placement(0, destination) - placement(0, blank);
+        blank = destination;
+
+        auto visited = first_visit.find(hash);
+        if (visited == first_visit.end()) {
+            kept.push_back(moves[i]);
+            hashes.push_back(hash);
+            first_visit.emplace(hash, kept.size());
+            continue;
+        }
+        while (kept.size() > visited->second) {
+            first_visit.erase(hashes.back());
+            hashes.pop_back();
+            kept.pop_back();
+        }
+    }
+    return kept;
+}
+
+MoveString PathOptimizer::optimize_board(const std::vector<tile_type>& start, int width, const MoveString& moves) {
+    windows_improved = 0;
+    nodes_expanded = 0;
+    auto deadline = time_budget > 0
+                    ? clock_type::now() + std::chrono::duration_cast<clock_type::duration>(std::chrono::duration<double>(time_budget))
+                    : clock_type::time_point::max();
+
+    MoveString path = remove_loops(start, width, cancel_inverses(moves));
+    int idle_rounds = 0;
+    for (size_t round = 0; idle_rounds < 2 && clock_type::now() < deadline; round++) {
+        size_t first = round % 2 == 0 ? 0 : static_cast<size_t>(window_length / 2);
+        if (optimize_windows(start, width, path, first, deadline)) {
+            path = remove_loops(start, width, cancel_inverses(path));
+            idle_rounds = 0;
+        } else {
+            idle_rounds++;
+        }
+    }
+
+    //// a hash collision in remove_loops() would show up here
+    if (replay(start, width, path) != replay(start, width, moves)) return moves;
+    return path;
+}
+
+bool PathOptimizer::optimize_windows(const std::vector<tile_type>& start, int width, MoveString& moves, size_t first,
+                                     clock_type::time_point deadline) {
+    size_t length = static_cast<size_t>(window_length);
+    if (moves.size() < first + length) return false;
+    size_t count = (moves.size() - first) / length;
+
+    //// the boards at every window boundary
+    std::vector<std::vector<tile_type>> boards;
+    std::vector<tile_type> board = start;
+    int blank = find_blank(board);
+    for (size_t i = 0; i <= first + count * length; i++) {
+        if (i >= first && (i - first) % length == 0) boards.push_back(board);
+        if (i < moves.size()) blank = slide(board, width, blank, moves[i]);
+    }
+
+    std::vector<MoveString> replacements(count);
+    std::vector<uint8_t> improved(count, 0);
+    std::atomic<size_t> next_window(0);
+    std::mutex guard;
+    auto work = [&]() {
+        unsigned long long nodes = 0;
+        for (size_t w = next_window++; w < count && clock_type::now() < deadline; w = next_window++) {
+            WindowSearch search(width, boards[w], boards[w + 1], deadline);
+            improved[w] = search.solve(window_length, replacements[w]) ? 1 : 0;
+            nodes += search.get_nodes_expanded();
+        }
+        std::lock_guard<std::mutex> lock(guard);
+        nodes_expanded += nodes;
+    };
+    std::vector<std::thread> pool;
+    for (int i = 1; i < threads; i++) pool.emplace_back(work);
+    work();
+    for (auto& thread : pool) thread.join();
+
+    size_t shortened = static_cast<size_t>(std::count(improved.begin(), improved.end(), 1));
+    if (shortened == 0) return false;
+    windows_improved += shortened;
+    MoveString rebuilt;
+    for (size_t i = 0; i < first; i++) rebuilt.push_back(moves[i]);
+    for (size_t w = 0; w < count; w++) {
+        if (improved[w]) {
+            rebuilt.append(replacements[w]);
+        } else {
+            for (size_t i = first + w * length; i < first + (w + 1) * length; i++) rebuilt.push_back(moves[i]);
+        }
+    }
+    for (size_t i = first + count * length; i < moves.size(); i++) rebuilt.push_back(moves[i]);
+    moves = rebuilt;
+    return true;
+}
@@ -0,0 +1,67 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef PATHOPTIMIZER_H
+#define PATHOPTIMIZER_H
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "MoveString.h"
+
+
+// Shortens the paths the suboptimal modes return (inadmissible heuristics,
+// LargeBoardSolver) after the fact, for any board width up to 255:
+//   1. moves undone right away by the next are dropped,
+//   2. loops are cut out - the boards along the path are hashed and a path
+//      that comes back to a board skips straight from the first visit,
+//   3. windows of `window_length` moves are solved again optimally, IDA*
+//      from the board before a window to the board after it with Manhattan
+//      distance between the two and a bound just below the window, and a
+//      shorter way replaces the window.
+// The windows of a round are disjoint and shared out between the threads;
+// rounds alternate between windows starting at 0 and at half a window, so
+// every boundary falls inside some window, and go on until two rounds in a
+// row find nothing or the time budget runs out. The boards are hashed with a
+// 64-bit sum of mixed (tile, cell) pairs, the result is replayed against the
+// original end board and thrown away on the astronomically rare collision.
+class PathOptimizer {
+public:
+    typedef uint16_t tile_type;
+
+    // throws std::invalid_argument for windows shorter than 2 moves
+    explicit PathOptimizer(int _window_length = 16, int _threads = static_cast<int>(std::thread::hardware_concurrency()));
+
+    // 0 (the default) lets the rounds run until they stop finding shorter windows
+    void set_time_budget(double seconds) { time_budget = seconds; }
+
+    // throws std::invalid_argument when the moves leave the board
+    template<class Tile>
+    MoveString optimize(const Tile* game_state, int width, const MoveString& moves) {
+        std::vector<tile_type> start(game_state, game_state + width * width);
+        return optimize_board(start, width, moves);
+    }
+
+    //// the passes on their own
+    static MoveString cancel_inverses(const MoveString& moves);
+    static MoveString remove_loops(const std::vector<tile_type>& start, int width, const MoveString& moves);
+
+    size_t get_windows_improved() const { return windows_improved; }
+    unsigned long long get_nodes_expanded() const { return nodes_expanded; }
+
+private:
+    int window_length;
+    int threads;
+    double time_budget = 0;
+    size_t windows_improved = 0;
+    unsigned long long nodes_expanded = 0;
+
+    MoveString optimize_board(const std::vector<tile_type>& start, int width, const MoveString& moves);
+    // one round over the windows from `first`, false when none got shorter
+    bool optimize_windows(const std::vector<tile_type>& start, int width, MoveString& moves, size_t first,
+                          std::chrono::steady_clock::time_point deadline);
+};
+
+
+#endif //PATHOPTIMIZER_H
@@ -0,0 +1,125 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "PatternDatabase.h"
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+static const char pdb_magic[4] = {'W', 'S', 'I', 'P'};
+static const char compressed_magic[4] = {'W', 'S', 'I', 'Q'};
+
+
+void PatternDatabase::load(const std::string& path) {
+    file.open(path);
+    patterns.clear();
+    const unsigned char* data = file.data();
+    size_t size = file.size(), offset = 12;
+
+    uint32_t stored_width = 0, count = 0, code = exact, stored_group = 1;
+    bool compressed = size >= 20 && std::memcmp(data, compressed_magic, 4) == 0;
+    if (size < offset || (!compressed && std::memcmp(data, pdb_magic, 4) != 0)) {
+        throw std::runtime_error(path + " is not a pattern database");
+    }
+    std::memcpy(&stored_width, data + 4, 4);
+    std::memcpy(&count, data + 8, 4);
+    if (compressed) {
+        std::memcpy(&code, data + 12, 4);
+        std::memcpy(&stored_group, data + 16, 4);
+        offset = 20;
+    }
+    if (code > modulo_three || stored_group == 0 || (code == modulo_three && stored_group != 1)
+        || count > max_patterns || stored_width * stored_width > Ranking::max_elements) {
+        throw std::runtime_error(path + " has an unknown encoding");
+    }
+    width = static_cast<int>(stored_width);
+    stored_encoding = static_cast<encoding>(code);
+    group = static_cast<int>(stored_group);
+    tile_pattern.assign(width * width, -1);
+
+    for (uint32_t p = 0; p < count; p++) {
+        uint32_t k = 0;
+        if (offset + 4 > size) throw std::runtime_error(path + " is truncated");
+        std::memcpy(&k, data + offset, 4);
+        offset += 4;
+        if (offset + k > size || static_cast<int>(k) >= width * width) throw std::runtime_error(path + " is truncated");
+
+        Pattern pattern;
+        pattern.tiles.assign(data + offset, data + offset + k);
+        pattern.entries = Ranking::count(width * width, static_cast<int>(k));
+        for (char tile : pattern.tiles) {
+            if (tile <= 0 || tile >= width * width) throw std::runtime_error(path + " has a tile out of range");
+            tile_pattern[static_cast<int>(tile)] = static_cast<int>(patterns.size());
+        }
+        patterns.push_back(pattern);
+        offset += k;
+    }
+    for (auto& pattern : patterns) {
+        uint64_t bytes = stored_size(pattern.entries, stored_encoding, group);
+        if (offset + bytes > size) throw std::runtime_error(path + " is truncated");
+        pattern.distances = data + offset;
+        offset += bytes;
+    }
+}
+
+int PatternDatabase::recover(int pattern, const char* game_state) const {
+    const Pattern& p = patterns[pattern];
+    int k = static_cast<int>(p.tiles.size()), n = width * width;
+    char cells[Ranking::max_elements];
+    bool occupied[Ranking::max_elements] = {};
+    Ranking::pattern_cells(game_state, n, p.tiles.data(), k, cells);
+    for (int i = 0; i < k; i++) occupied[static_cast<int>(cells[i])] = true;
+
+    //// every placement but the goal has a neighbour one closer to it,
+    //// and among neighbours (value - 1, value, value + 1) its residue is unique
+    int steps = 0;
+    int residue = stored(pattern, Ranking::lex_rank(cells, k, n));
+    while (true) {
+        bool home = true;
+        for (int i = 0; i < k && home; i++) home = cells[i] == p.tiles[i] - 1;
+        if (home) return steps;
+
+        bool descended = false;
+        for (int i = 0; i < k && !descended; i++) {
+            int cell = cells[i], x = cell % width, y = cell / width;
+            int neighbours[4] = {y > 0 ? cell - width : -1, y < width - 1 ? cell + width : -1,
+                                 x > 0 ? cell - 1 : -1, x < width - 1 ? cell + 1 : -1};
+            for (int neighbour : neighbours) {
+                if (neighbour < 0 || occupied[neighbour]) continue;
+                cells[i] = static_cast<char>(neighbour);
+                int next = stored(pattern, Ranking::lex_rank(cells, k, n));
+                if (next == (residue + 2) % 3) {
+                    occupied[cell] = false;
+                    occupied[neighbour] = true;
+                    residue = next;
+                    descended = true;
+                    break;
+                }
+                cells[i] = static_cast<char>(cell);
+            }
+        }
+        if (!descended) throw std::runtime_error("pattern database is not consistent, cannot recover a value");
+        steps++;
+    }
+}
+
+std::vector<std::vector<char>> PatternDatabase::parse_partition(const std::string& spec) {
+    std::vector<std::vector<char>> partition;
+    std::stringstream groups(spec);
+    std::string group;
+    while (std::getline(groups, group, '/')) {
+        std::vector<char> tiles;
+        std::stringstream numbers(group);
+        std::string number;
+        while (std::getline(numbers, number, ',')) {
+            if (number.empty()) continue;
+            int tile = std::stoi(number);
+            if (tile <= 0 || tile > 127) throw std::invalid_argument("pattern tile " + number + " out of range");
+            tiles.push_back(static_cast<char>(tile));
+        }
+        if (tiles.empty()) throw std::invalid_argument("empty pattern in partition " + spec);
+        partition.push_back(tiles);
+    }
+    return partition;
+}
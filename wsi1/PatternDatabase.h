@@ -0,0 +1,117 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef PATTERNDATABASE_H
+#define PATTERNDATABASE_H
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.h"
+#include "Ranking.h"
+
+
+// Additive pattern databases: the tiles are split into disjoint patterns and
+// for every placement of a pattern's tiles the table holds the fewest moves
+// of those tiles needed to bring them home (moves of other tiles are free).
+// The sum over the patterns is an admissible heuristic.
+// Entries are indexed by Ranking::lex_rank of the cells the pattern's tiles
+// occupy, in the order the tiles are listed in the pattern.
+//
+// Compressed databases come in two flavours:
+//   group > 1     - one byte holds the minimum of `group` consecutive entries
+//                   (lossy, still admissible)
+//   modulo_three  - 2 bits per entry hold the distance mod 3 of a consistent
+//                   version of the table; the value itself is rebuilt from
+//                   the parent's value during the search, see recover()
+//
+// file layout (written by PatternDatabaseBuilder, read through MappedFile):
+//   "WSIP", u32 width, u32 number of patterns                       (exact)
+//   "WSIQ", u32 width, u32 number of patterns, u32 encoding, u32 group  (compressed)
+//   per pattern: u32 k, k bytes of tile numbers
+//   per pattern: stored_size(entries) bytes, entries = n! / (n - k)!, n = width * width
+class PatternDatabase {
+public:
+    enum encoding { exact = 0, modulo_three = 1 };
+    static constexpr int max_patterns = 16;
+
+    struct Pattern {
+        std::vector<char> tiles;
+        uint64_t entries = 0;
+        const uint8_t* distances = nullptr;
+    };
+
+    PatternDatabase() = default;
+    explicit PatternDatabase(const std::string& path) { load(path); }
+
+    void load(const std::string& path); // throws std::runtime_error on a malformed file
+    bool is_loaded() const { return !patterns.empty(); }
+
+    int get_width() const { return width; }
+    encoding get_encoding() const { return stored_encoding; }
+    int get_group() const { return group; }
+    size_t size_in_bytes() const { return file.size(); }
+    const std::vector<Pattern>& get_patterns() const { return patterns; }
+    int pattern_of(char tile) const { return tile_pattern[static_cast<int>(tile)]; } // -1 for tiles of no pattern
+
+    // bytes a table of `entries` entries takes with the given encoding and group
+    static uint64_t stored_size(uint64_t entries, encoding _encoding, int _group) {
+        return _encoding == modulo_three ? (entries + 3) / 4 : (entries + _group - 1) / _group;
+    }
+
+    uint64_t index(int pattern, const char* game_state) const {
+        char cells[Ranking::max_elements];
+        const Pattern& p = patterns[pattern];
+        Ranking::pattern_cells(game_state, width * width, p.tiles.data(), static_cast<int>(p.tiles.size()), cells);
+        return Ranking::lex_rank(cells, static_cast<int>(p.tiles.size()), width * width);
+    }
+
+    // the stored value of entry `index`: a distance, or a residue mod 3 for modulo_three
+    int stored(int pattern, uint64_t index) const {
+        const uint8_t* distances = patterns[pattern].distances;
+        if (stored_encoding == modulo_three) return (distances[index >> 2] >> (2 * (index & 3))) & 3;
+        return group == 1 ? distances[index] : distances[index / group];
+    }
+
+    int lookup(int pattern, const char* game_state) const {
+        return stored(pattern, index(pattern, game_state));
+    }
+
+    // asks for the cache line of entry `index` ahead of a stored() on it
+    void prefetch(int pattern, uint64_t index) const {
+        const uint8_t* distances = patterns[pattern].distances;
+        __builtin_prefetch(stored_encoding == modulo_three ? distances + (index >> 2) : distances + index / group);
+    }
+
+    // modulo_three: the value of a pattern with no parent to start from, found by
+    // walking down to the goal placement one residue step at a time
+    int recover(int pattern, const char* game_state) const;
+
+    // modulo_three: the child value is the one of parent - 1, parent, parent + 1
+    // that has the stored residue
+    static int next_value(int parent, int residue) {
+        return parent + (residue - parent % 3 + 4) % 3 - 1;
+    }
+
+    int evaluate(const char* game_state) const {
+        int sum = 0;
+        for (int p = 0; p < static_cast<int>(patterns.size()); p++) {
+            sum += stored_encoding == modulo_three ? recover(p, game_state) : lookup(p, game_state);
+        }
+        return sum;
+    }
+
+    // "1,2,3,4,5,6,7/8,9,10,11,12,13,14,15" -> {{1..7}, {8..15}}
+    static std::vector<std::vector<char>> parse_partition(const std::string& spec);
+
+private:
+    MappedFile file;
+    int width = 0;
+    encoding stored_encoding = exact;
+    int group = 1;
+    std::vector<Pattern> patterns;
+    std::vector<int> tile_pattern;
+};
+
+
+#endif //PATTERNDATABASE_H
@@ -0,0 +1,403 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "PatternDatabaseBuilder.h"
+#include "PatternDatabase.h"
+#include "MoveString.h"
+#include "Ranking.h"
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <filesystem>
+#include <stdexcept>
+
+static const char pdb_magic[4] = {'W', 'S', 'I', 'P'};
+static const char compressed_magic[4] = {'W', 'S', 'I', 'Q'};
+static const char checkpoint_magic[4] = {'W', 'S', 'I', 'K'};
+
+
+PatternDatabaseBuilder::PatternDatabaseBuilder(int _width, unsigned _threads, std::string _checkpoint_directory, int _checkpoint_interval) {
+    width = _width;
+    cells = width * width;
+    threads = std::max(_threads, 1u);
+    checkpoint_directory = std::move(_checkpoint_directory);
+    checkpoint_interval = std::max(_checkpoint_interval, 1);
+    if (cells > Ranking::max_elements) {
+        throw std::invalid_argument("board too large for pattern databases");
+    }
+}
+
+bool PatternDatabaseBuilder::try_mark(uint64_t entry, unsigned from_mask, uint64_t to) {
+    std::atomic<uint64_t>& word = codes[entry / 32];
+    int shift = 2 * static_cast<int>(entry % 32);
+    uint64_t current = word.load(std::memory_order_relaxed);
+    while (true) {
+        uint64_t code = (current >> shift) & 3;
+        if (!(from_mask & (1u << code))) return false;
+        uint64_t updated = (current & ~(uint64_t(3) << shift)) | (to << shift);
+        if (word.compare_exchange_weak(current, updated, std::memory_order_relaxed)) return true;
+    }
+}
+
+void PatternDatabaseBuilder::lower_distance(uint64_t pattern_index, uint8_t distance) {
+    std::atomic<uint8_t>& slot = distances[pattern_index];
+    uint8_t current = slot.load(std::memory_order_relaxed);
+    while (distance < current && !slot.compare_exchange_weak(current, distance, std::memory_order_relaxed)) {}
+}
+
+void PatternDatabaseBuilder::expand_level(uint8_t level) {
+    std::vector<std::thread> workers;
+    uint64_t slice = (num_of_words + threads - 1) / threads;
+
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            uint64_t first_word = std::min<uint64_t>(num_of_words, t * slice);
+            uint64_t last_word = std::min<uint64_t>(num_of_words, first_word + slice);
+            char positions[Ranking::max_elements];
+            bool occupied[Ranking::max_elements];
+            std::vector<uint64_t> stack; // entries reached by free moves, expanded right away
+
+            for (uint64_t w = first_word; w < last_word; w++) {
+                //// code 2 (binary 10) has the high bit set and the low bit clear
+                uint64_t word = codes[w].load(std::memory_order_relaxed);
+                uint64_t high = word & 0xAAAAAAAAAAAAAAAAULL, low = (word << 1) & 0xAAAAAAAAAAAAAAAAULL;
+                for (uint64_t pending = high & ~low; pending != 0; pending &= pending - 1) {
+                    uint64_t entry = w * 32 + Ranking::popcount((pending & (~pending + 1)) - 1) / 2;
+                    if (!try_mark(entry, 1u << waiting, expanded)) continue;
+                    stack.push_back(entry);
+
+                    while (!stack.empty()) {
+                        uint64_t current = stack.back();
+                        stack.pop_back();
+                        Ranking::lex_unrank(current, k + 1, cells, positions);
+                        std::fill(occupied, occupied + cells, false);
+                        for (int i = 0; i < k; i++) occupied[static_cast<int>(positions[i])] = true;
+                        int blank = positions[k];
+                        int x = blank % width, y = blank / width;
+
+                        for (int move = MoveString::up; move <= MoveString::right; move++) {
+                            if ((move == MoveString::up && y == 0) || (move == MoveString::down && y == width - 1)
+                                || (move == MoveString::left && x == 0) || (move == MoveString::right && x == width - 1)) continue;
+                            int destination = blank + MoveString::offset(move, width);
+
+                            if (!occupied[destination]) {
+                                //// free move - the child belongs to this very level
+                                positions[k] = static_cast<char>(destination);
+                                uint64_t child = Ranking::lex_rank(positions, k + 1, cells);
+                                if (try_mark(child, (1u << unseen) | (1u << next_level), expanded)) {
+                                    lower_distance(child / (cells - k), level);
+                                    stack.push_back(child);
+                                }
+                                positions[k] = static_cast<char>(blank);
+                            } else {
+                                //// a pattern tile slides onto the blank
+                                int tile = 0;
+                                while (positions[tile] != destination) tile++;
+                                positions[tile] = static_cast<char>(blank);
+                                positions[k] = static_cast<char>(destination);
+                                uint64_t child = Ranking::lex_rank(positions, k + 1, cells);
+                                if (try_mark(child, 1u << unseen, next_level)) {
+                                    lower_distance(child / (cells - k), static_cast<uint8_t>(level + 1));
+                                }
+                                positions[tile] = static_cast<char>(destination);
+                                positions[k] = static_cast<char>(blank);
+                            }
+                        }
+                    }
+                }
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+uint64_t PatternDatabaseBuilder::promote_next_level() {
+    std::vector<std::thread> workers;
+    std::vector<uint64_t> promoted(threads, 0);
+    uint64_t slice = (num_of_words + threads - 1) / threads;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            uint64_t first_word = std::min<uint64_t>(num_of_words, t * slice);
+            uint64_t last_word = std::min<uint64_t>(num_of_words, first_word + slice);
+            for (uint64_t w = first_word; w < last_word; w++) {
+                uint64_t word = codes[w].load(std::memory_order_relaxed);
+                uint64_t updated = word;
+                for (int i = 0; i < 32; i++) {
+                    if (((word >> (2 * i)) & 3) == next_level) {
+                        updated = (updated & ~(uint64_t(3) << (2 * i))) | (waiting << (2 * i));
+                        promoted[t]++;
+                    }
+                }
+                codes[w].store(updated, std::memory_order_relaxed); // no other thread touches this word now
+            }
+        });
+    }
+    for (auto& worker : workers) worker.join();
+
+    uint64_t total = 0;
+    for (auto count : promoted) total += count;
+    return total;
+}
+
+std::vector<uint8_t> PatternDatabaseBuilder::build_pattern(const std::vector<char>& tiles, const std::string& checkpoint_path) {
+    k = static_cast<int>(tiles.size());
+    if (k + 1 > cells) {
+        throw std::invalid_argument("pattern has more tiles than the board");
+    }
+    entries = Ranking::count(cells, k + 1);
+    num_of_words = (entries + 31) / 32;
+    num_of_distances = Ranking::count(cells, k);
+    codes.reset(new std::atomic<uint64_t>[num_of_words]);
+    distances.reset(new std::atomic<uint8_t>[num_of_distances]);
+
+    int level = 0;
+    bool finished = false;
+    if (checkpoint_path.empty() || !load_checkpoint(checkpoint_path, tiles, level, finished)) {
+        for (uint64_t w = 0; w < num_of_words; w++) codes[w].store(0, std::memory_order_relaxed);
+        for (uint64_t i = 0; i < num_of_distances; i++) distances[i].store(no_distance, std::memory_order_relaxed);
+
+        //// the goal: every tile t at cell t - 1, blank in the last cell
+        char goal[Ranking::max_elements];
+        for (int i = 0; i < k; i++) goal[i] = static_cast<char>(tiles[i] - 1);
+        goal[k] = static_cast<char>(cells - 1);
+        uint64_t start = Ranking::lex_rank(goal, k + 1, cells);
+        try_mark(start, 1u << unseen, waiting);
+        lower_distance(start / (cells - k), 0);
+    }
+
+    while (!finished) {
+        expand_level(static_cast<uint8_t>(level));
+        uint64_t next = promote_next_level();
+        if (verbose) std::cout << "  level " << level + 1 << ": " << next << " entries" << std::endl;
+        if (next == 0) {
+            finished = true;
+        } else if (++level >= no_distance) {
+            throw std::runtime_error("pattern distances do not fit into a byte");
+        }
+        if (!checkpoint_path.empty() && (finished || level % checkpoint_interval == 0)) {
+            save_checkpoint(checkpoint_path, tiles, level, finished);
+        }
+    }
+
+    std::vector<uint8_t> table(num_of_distances);
+    for (uint64_t i = 0; i < num_of_distances; i++) table[i] = distances[i].load(std::memory_order_relaxed);
+    codes.reset();
+    distances.reset();
+    return table;
+}
+
+void PatternDatabaseBuilder::build(const std::vector<std::vector<char>>& partition, const std::string& output) {
+    std::vector<bool> used(cells, false);
+    for (const auto& tiles : partition) {
+        for (char tile : tiles) {
+            if (tile <= 0 || tile >= cells || used[tile]) {
+                throw std::invalid_argument("patterns have to be disjoint sets of tiles 1.." + std::to_string(cells - 1));
+            }
+            used[tile] = true;
+        }
+    }
+    if (!checkpoint_directory.empty()) std::filesystem::create_directories(checkpoint_directory);
+
+    std::vector<std::vector<uint8_t>> tables;
+    std::vector<std::string> checkpoints;
+    for (size_t p = 0; p < partition.size(); p++) {
+        std::string checkpoint_path;
+        if (!checkpoint_directory.empty()) {
+            checkpoint_path = checkpoint_directory + "/pattern_" + std::to_string(p) + ".ckpt";
+        }
+        if (verbose) std::cout << "pattern " << p << " (" << partition[p].size() << " tiles)" << std::endl;
+        tables.push_back(build_pattern(partition[p], checkpoint_path));
+        checkpoints.push_back(checkpoint_path);
+    }
+
+    std::string temporary = output + ".tmp";
+    std::FILE* out = std::fopen(temporary.c_str(), "wb");
+    if (out == nullptr) {
+        throw std::runtime_error("cannot write pattern database " + output);
+    }
+    uint32_t stored_width = static_cast<uint32_t>(width), count = static_cast<uint32_t>(partition.size());
+    std::fwrite(pdb_magic, 1, 4, out);
+    std::fwrite(&stored_width, 4, 1, out);
+    std::fwrite(&count, 4, 1, out);
+    for (const auto& tiles : partition) {
+        uint32_t size = static_cast<uint32_t>(tiles.size());
+        std::fwrite(&size, 4, 1, out);
+        std::fwrite(tiles.data(), 1, tiles.size(), out);
+    }
+    for (const auto& table : tables) std::fwrite(table.data(), 1, table.size(), out);
+    //// a full disk shows up in ferror() or only when fclose() flushes the last buffer
+    bool written = std::ferror(out) == 0;
+    if (std::fclose(out) != 0) written = false;
+    if (!written) {
+        std::filesystem::remove(temporary);
+        throw std::runtime_error("cannot write pattern database " + output);
+    }
+    std::filesystem::rename(temporary, output);
+
+    for (const auto& checkpoint : checkpoints) {
+        if (!checkpoint.empty()) std::filesystem::remove(checkpoint);
+    }
+}
+
+void PatternDatabaseBuilder::make_consistent(std::vector<uint8_t>& table, const std::vector<char>& tiles, int width) {
+    int k = static_cast<int>(tiles.size()), n = width * width;
+    char cells[Ranking::max_elements];
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (uint64_t index = 0; index < table.size(); index++) {
+            if (table[index] == no_distance) continue;
+            Ranking::lex_unrank(index, k, n, cells);
+            bool occupied[Ranking::max_elements] = {};
+            for (int i = 0; i < k; i++) occupied[static_cast<int>(cells[i])] = true;
+            uint8_t bound = static_cast<uint8_t>(table[index] + 1);
+
+            for (int i = 0; i < k; i++) {
+                int cell = cells[i], x = cell % width, y = cell / width;
+                int neighbours[4] = {y > 0 ? cell - width : -1, y < width - 1 ? cell + width : -1,
+                                     x > 0 ? cell - 1 : -1, x < width - 1 ? cell + 1 : -1};
+                for (int neighbour : neighbours) {
+                    if (neighbour < 0 || occupied[neighbour]) continue;
+                    cells[i] = static_cast<char>(neighbour);
+                    uint8_t& other = table[Ranking::lex_rank(cells, k, n)];
+                    if (other > bound) {
+                        other = bound;
+                        changed = true;
+                    }
+                }
+                cells[i] = static_cast<char>(cell);
+            }
+        }
+    }
+}
+
+void PatternDatabaseBuilder::compress(const std::string& input, const std::string& output,
+                                      PatternDatabase::encoding _encoding, int group) {
+    if (group < 1 || (_encoding == PatternDatabase::modulo_three && group != 1)) {
+        throw std::invalid_argument("modulo-3 tables need every entry, min-compression needs a group of at least 1");
+    }
+    PatternDatabase source(input);
+    if (source.get_encoding() != PatternDatabase::exact || source.get_group() != 1) {
+        throw std::invalid_argument(input + " is compressed already");
+    }
+    const auto& patterns = source.get_patterns();
+
+    std::string temporary = output + ".tmp";
+    std::FILE* out = std::fopen(temporary.c_str(), "wb");
+    if (out == nullptr) {
+        throw std::runtime_error("cannot write pattern database " + output);
+    }
+    uint32_t header[4] = {static_cast<uint32_t>(source.get_width()), static_cast<uint32_t>(patterns.size()),
+                          static_cast<uint32_t>(_encoding), static_cast<uint32_t>(group)};
+    std::fwrite(compressed_magic, 1, 4, out);
+    std::fwrite(header, 4, 4, out);
+    for (const auto& pattern : patterns) {
+        uint32_t size = static_cast<uint32_t>(pattern.tiles.size());
+        std::fwrite(&size, 4, 1, out);
+        std::fwrite(pattern.tiles.data(), 1, pattern.tiles.size(), out);
+    }
+
+    for (const auto& pattern : patterns) {
+        std::vector<uint8_t> packed(PatternDatabase::stored_size(pattern.entries, _encoding, group), 0);
+        if (_encoding == PatternDatabase::modulo_three) {
+            std::vector<uint8_t> table(pattern.distances, pattern.distances + pattern.entries);
+            make_consistent(table, pattern.tiles, source.get_width());
+            for (uint64_t i = 0; i < table.size(); i++) packed[i >> 2] |= (table[i] % 3) << (2 * (i & 3));
+        } else {
+            std::fill(packed.begin(), packed.end(), no_distance);
+            for (uint64_t i = 0; i < pattern.entries; i++) {
+                packed[i / group] = std::min(packed[i / group], pattern.distances[i]);
+            }
+        }
+        std::fwrite(packed.data(), 1, packed.size(), out);
+    }
+    bool written = std::ferror(out) == 0;
+    if (std::fclose(out) != 0) written = false;
+    if (!written) {
+        std::filesystem::remove(temporary);
+        throw std::runtime_error("cannot write pattern database " + output);
+    }
+    std::filesystem::rename(temporary, output);
+}
+
+// "WSIK", u32 width, u32 k, k tiles, i32 level, u32 finished, then the code words and the distances
+void PatternDatabaseBuilder::save_checkpoint(const std::string& path, const std::vector<char>& tiles, int level, bool finished) const {
+    std::string temporary = path + ".tmp";
+    std::FILE* out = std::fopen(temporary.c_str(), "wb");
+    if (out == nullptr) {
+        throw std::runtime_error("cannot write checkpoint " + path);
+    }
+    uint32_t stored_width = static_cast<uint32_t>(width), size = static_cast<uint32_t>(k), done = finished;
+    int32_t stored_level = level;
+    std::fwrite(checkpoint_magic, 1, 4, out);
+    std::fwrite(&stored_width, 4, 1, out);
+    std::fwrite(&size, 4, 1, out);
+    std::fwrite(tiles.data(), 1, tiles.size(), out);
+    std::fwrite(&stored_level, 4, 1, out);
+    std::fwrite(&done, 4, 1, out);
+
+    std::vector<uint64_t> buffer;
+    buffer.reserve(1 << 16);
+    for (uint64_t w = 0; w < num_of_words; w++) {
+        buffer.push_back(codes[w].load(std::memory_order_relaxed));
+        if (buffer.size() == buffer.capacity() || w + 1 == num_of_words) {
+            std::fwrite(buffer.data(), sizeof(uint64_t), buffer.size(), out);
+            buffer.clear();
+        }
+    }
+    std::vector<uint8_t> bytes;
+    bytes.reserve(1 << 20);
+    for (uint64_t i = 0; i < num_of_distances; i++) {
+        bytes.push_back(distances[i].load(std::memory_order_relaxed));
+        if (bytes.size() == bytes.capacity() || i + 1 == num_of_distances) {
+            std::fwrite(bytes.data(), 1, bytes.size(), out);
+            bytes.clear();
+        }
+    }
+    bool written = std::ferror(out) == 0;
+    if (std::fclose(out) != 0) written = false;
+    if (!written) {
+        std::filesystem::remove(temporary);
+        throw std::runtime_error("cannot write checkpoint " + path);
+    }
+    std::filesystem::rename(temporary, path);
+}
+
+bool PatternDatabaseBuilder::load_checkpoint(const std::string& path, const std::vector<char>& tiles, int& level, bool& finished) {
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    if (in == nullptr) return false;
+
+    char magic[4];
+    uint32_t stored_width = 0, size = 0, done = 0;
+    int32_t stored_level = 0;
+    std::vector<char> stored_tiles(tiles.size());
+    bool matches = std::fread(magic, 1, 4, in) == 4 && std::memcmp(magic, checkpoint_magic, 4) == 0
+                   && std::fread(&stored_width, 4, 1, in) == 1 && stored_width == static_cast<uint32_t>(width)
+                   && std::fread(&size, 4, 1, in) == 1 && size == tiles.size()
+                   && std::fread(stored_tiles.data(), 1, size, in) == size && stored_tiles == tiles
+                   && std::fread(&stored_level, 4, 1, in) == 1 && std::fread(&done, 4, 1, in) == 1;
+
+    std::vector<uint64_t> buffer(1 << 16);
+    for (uint64_t w = 0; matches && w < num_of_words; w += buffer.size()) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(buffer.size(), num_of_words - w));
+        matches = std::fread(buffer.data(), sizeof(uint64_t), chunk, in) == chunk;
+        for (size_t i = 0; matches && i < chunk; i++) codes[w + i].store(buffer[i], std::memory_order_relaxed);
+    }
+    std::vector<uint8_t> bytes(1 << 20);
+    for (uint64_t d = 0; matches && d < num_of_distances; d += bytes.size()) {
+        size_t chunk = static_cast<size_t>(std::min<uint64_t>(bytes.size(), num_of_distances - d));
+        matches = std::fread(bytes.data(), 1, chunk, in) == chunk;
+        for (size_t i = 0; matches && i < chunk; i++) distances[d + i].store(bytes[i], std::memory_order_relaxed);
+    }
+    std::fclose(in);
+
+    if (!matches) {
+        if (verbose) std::cout << "  ignoring checkpoint " << path << " (different pattern or damaged)" << std::endl;
+        return false;
+    }
+    level = stored_level;
+    finished = done != 0;
+    if (verbose) std::cout << "  resuming from checkpoint at level " << level << std::endl;
+    return true;
+}
@@ -0,0 +1,81 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef PATTERNDATABASEBUILDER_H
+#define PATTERNDATABASEBUILDER_H
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <thread>
+#include <memory>
+#include "PatternDatabase.h"
+
+
+// Builds the files PatternDatabase loads.
+//
+// Each pattern is a level-synchronous breadth-first search from the goal over
+// (cells of the pattern's tiles, cell of the blank), indexed by
+// Ranking::lex_rank with the blank last. Blank moves into cells of other tiles
+// cost nothing, moves of a pattern tile cost one.
+// The search keeps 2 bits per entry in an array of atomic words:
+//   unseen -> next level -> waiting (current level) -> expanded
+// Every level is one sweep over the array split between the worker threads,
+// which claim and publish entries with compare-and-swap; entries reached by
+// free moves are expanded on the spot from a thread-local stack. The table
+// written out keeps the minimum over the blank cells of every placement.
+// With a checkpoint directory set the search state is saved after every
+// `checkpoint_interval` levels and a rerun continues where it stopped.
+class PatternDatabaseBuilder {
+public:
+    PatternDatabaseBuilder(int width, unsigned threads = std::thread::hardware_concurrency(),
+                           std::string checkpoint_directory = "", int checkpoint_interval = 1);
+
+    void build(const std::vector<std::vector<char>>& partition, const std::string& output);
+    std::vector<uint8_t> build_pattern(const std::vector<char>& tiles, const std::string& checkpoint_path);
+
+    void set_verbose(bool _verbose) { verbose = _verbose; }
+
+    // rewrites a database in a compressed encoding: min over `group` consecutive
+    // entries, or residues mod 3 of the table after make_consistent()
+    static void compress(const std::string& input, const std::string& output,
+                         PatternDatabase::encoding _encoding, int group);
+    // lowers entries until neighbouring placements differ by at most one;
+    // min over the blank makes single tile moves jump by 3 or more otherwise
+    static void make_consistent(std::vector<uint8_t>& table, const std::vector<char>& tiles, int width);
+
+private:
+    static constexpr uint64_t unseen = 0, expanded = 1, waiting = 2, next_level = 3;
+    static constexpr uint8_t no_distance = 0xFF;
+
+    int width;
+    int cells;
+    unsigned threads;
+    std::string checkpoint_directory;
+    int checkpoint_interval;
+    bool verbose = true;
+
+    // search state of the pattern being built
+    int k = 0;
+    uint64_t entries = 0;
+    std::unique_ptr<std::atomic<uint64_t>[]> codes;
+    uint64_t num_of_words = 0;
+    std::unique_ptr<std::atomic<uint8_t>[]> distances;
+    uint64_t num_of_distances = 0;
+
+    uint64_t code_of(uint64_t entry) const {
+        return (codes[entry / 32].load(std::memory_order_relaxed) >> (2 * (entry % 32))) & 3;
+    }
+    // moves the entry to `to` if its code is one of the codes flagged in `from_mask`
+    bool try_mark(uint64_t entry, unsigned from_mask, uint64_t to);
+    void lower_distance(uint64_t pattern_index, uint8_t distance);
+
+    void expand_level(uint8_t level);
+    uint64_t promote_next_level();
+    void save_checkpoint(const std::string& path, const std::vector<char>& tiles, int level, bool finished) const;
+    bool load_checkpoint(const std::string& path, const std::vector<char>& tiles, int& level, bool& finished);
+};
+
+
+#endif //PATTERNDATABASEBUILDER_H
@@ -0,0 +1,211 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef PATTERNHEURISTIC_H
+#define PATTERNHEURISTIC_H
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "PatternDatabase.h"
+#include "Symmetry.h"
+
+
+// IdaStar heuristics over a PatternDatabase. A node keeps the value of every
+// pattern, a move only touches the pattern of the tile that slid.
+struct PatternValues {
+    uint8_t parts[PatternDatabase::max_patterns];
+    int total;
+};
+
+// update() split in two for the interleaved search (InterleavedIdaStar):
+// prepare() finds the entry and prefetches it, complete() reads it later
+struct PendingLookup {
+    int pattern;
+    uint64_t index;
+};
+
+// exact or min-compressed databases: each lookup is the value itself
+class PatternHeuristic {
+public:
+    typedef PatternValues value_type;
+
+    static const char* name() { return "pdb"; }
+    // taking the minimum over the blank lets one move change a pattern by 3 or more
+    static constexpr bool is_admissible = true, is_consistent = false;
+
+    explicit PatternHeuristic(const PatternDatabase& _database) : database(_database) {}
+
+    value_type evaluate(const char* game_state) const {
+        value_type value{};
+        for (int p = 0; p < static_cast<int>(database.get_patterns().size()); p++) {
+            value.parts[p] = static_cast<uint8_t>(database.lookup(p, game_state));
+            value.total += value.parts[p];
+        }
+        return value;
+    }
+
+    value_type update(const value_type& parent, const char* game_state, char tile, int, int, int) const {
+        int p = database.pattern_of(tile);
+        if (p < 0) return parent;
+        value_type value = parent;
+        value.parts[p] = static_cast<uint8_t>(database.lookup(p, game_state));
+        value.total += value.parts[p] - parent.parts[p];
+        return value;
+    }
+
+    PendingLookup prepare(const char* game_state, char tile) const {
+        int p = database.pattern_of(tile);
+        if (p < 0) return {p, 0};
+        PendingLookup pending{p, database.index(p, game_state)};
+        database.prefetch(p, pending.index);
+        return pending;
+    }
+
+    value_type complete(const value_type& parent, const PendingLookup& pending) const {
+        if (pending.pattern < 0) return parent;
+        value_type value = parent;
+        value.parts[pending.pattern] = static_cast<uint8_t>(database.stored(pending.pattern, pending.index));
+        value.total += value.parts[pending.pattern] - parent.parts[pending.pattern];
+        return value;
+    }
+
+    static int cost(const value_type& value) { return value.total; }
+
+private:
+    const PatternDatabase& database;
+};
+
+// modulo-3 databases: the stored residue picks the child value out of the
+// three the parent's value allows
+class ModuloPatternHeuristic {
+public:
+    typedef PatternValues value_type;
+
+    static const char* name() { return "pdb_mod3"; }
+    static constexpr bool is_admissible = true, is_consistent = true;
+
+    explicit ModuloPatternHeuristic(const PatternDatabase& _database) : database(_database) {}
+
+    value_type evaluate(const char* game_state) const {
+        value_type value{};
+        for (int p = 0; p < static_cast<int>(database.get_patterns().size()); p++) {
+            value.parts[p] = static_cast<uint8_t>(database.recover(p, game_state));
+            value.total += value.parts[p];
+        }
+        return value;
+    }
+
+    value_type update(const value_type& parent, const char* game_state, char tile, int, int, int) const {
+        int p = database.pattern_of(tile);
+        if (p < 0) return parent;
+        value_type value = parent;
+        value.parts[p] = static_cast<uint8_t>(PatternDatabase::next_value(parent.parts[p], database.lookup(p, game_state)));
+        value.total += value.parts[p] - parent.parts[p];
+        return value;
+    }
+
+    PendingLookup prepare(const char* game_state, char tile) const {
+        int p = database.pattern_of(tile);
+        if (p < 0) return {p, 0};
+        PendingLookup pending{p, database.index(p, game_state)};
+        database.prefetch(p, pending.index);
+        return pending;
+    }
+
+    value_type complete(const value_type& parent, const PendingLookup& pending) const {
+        if (pending.pattern < 0) return parent;
+        int p = pending.pattern;
+        value_type value = parent;
+        value.parts[p] = static_cast<uint8_t>(PatternDatabase::next_value(parent.parts[p], database.stored(p, pending.index)));
+        value.total += value.parts[p] - parent.parts[p];
+        return value;
+    }
+
+    static int cost(const value_type& value) { return value.total; }
+
+private:
+    const PatternDatabase& database;
+};
+
+// The board and its mirror across the main diagonal (see Symmetry) looked up
+// in the same exact or min-compressed database, the larger sum counts. Unless
+// the partition is its own mirror, the mirrored board falls apart into other
+// groups of tiles and often scores higher - the reflection of Korf and
+// Felner's 6-6-6-6 databases for the 5x5 board. A move changes one pattern on
+// each side.
+struct ReflectedPatternValues {
+    PatternValues direct, mirrored;
+};
+
+class ReflectedPatternHeuristic {
+public:
+    typedef ReflectedPatternValues value_type;
+
+    static const char* name() { return "pdb_reflected"; }
+    static constexpr bool is_admissible = true, is_consistent = false;
+
+    // throws std::invalid_argument for a modulo-3 database
+    explicit ReflectedPatternHeuristic(const PatternDatabase& _database) : database(_database), width(_database.get_width()) {
+        if (database.get_encoding() == PatternDatabase::modulo_three) {
+            throw std::invalid_argument("reflected lookups need an exact or min-compressed database");
+        }
+        mirror_pattern.assign(width * width, -1);
+        for (const auto& pattern : database.get_patterns()) {
+            //// tile t of the mirror stands where the original has relabel(t), transposed
+            std::vector<char> originals;
+            for (char tile : pattern.tiles) {
+                originals.push_back(Symmetry::relabel(tile, width));
+                mirror_pattern[static_cast<int>(originals.back())] = static_cast<int>(mirror_tiles.size());
+            }
+            mirror_tiles.push_back(originals);
+        }
+    }
+
+    value_type evaluate(const char* game_state) const {
+        value_type value{};
+        for (int p = 0; p < static_cast<int>(mirror_tiles.size()); p++) {
+            value.direct.parts[p] = static_cast<uint8_t>(database.lookup(p, game_state));
+            value.direct.total += value.direct.parts[p];
+            value.mirrored.parts[p] = static_cast<uint8_t>(database.stored(p, mirrored_index(p, game_state)));
+            value.mirrored.total += value.mirrored.parts[p];
+        }
+        return value;
+    }
+
+    value_type update(const value_type& parent, const char* game_state, char tile, int, int, int) const {
+        value_type value = parent;
+        int p = database.pattern_of(tile);
+        if (p >= 0) {
+            value.direct.parts[p] = static_cast<uint8_t>(database.lookup(p, game_state));
+            value.direct.total += value.direct.parts[p] - parent.direct.parts[p];
+        }
+        int q = mirror_pattern[static_cast<int>(tile)];
+        if (q >= 0) {
+            value.mirrored.parts[q] = static_cast<uint8_t>(database.stored(q, mirrored_index(q, game_state)));
+            value.mirrored.total += value.mirrored.parts[q] - parent.mirrored.parts[q];
+        }
+        return value;
+    }
+
+    static int cost(const value_type& value) { return value.direct.total > value.mirrored.total ? value.direct.total : value.mirrored.total; }
+
+private:
+    const PatternDatabase& database;
+    int width;
+    std::vector<std::vector<char>> mirror_tiles; // per pattern, the original tiles its mirrored tiles stand for
+    std::vector<int> mirror_pattern;             // tile -> the pattern it moves on the mirror side, -1 for none
+
+    // the index of pattern `pattern` over the mirrored board, read off the original
+    uint64_t mirrored_index(int pattern, const char* game_state) const {
+        char cells[Ranking::max_elements];
+        const std::vector<char>& tiles = mirror_tiles[pattern];
+        int k = static_cast<int>(tiles.size());
+        Ranking::pattern_cells(game_state, width * width, tiles.data(), k, cells);
+        for (int i = 0; i < k; i++) cells[i] = static_cast<char>(Symmetry::transpose(cells[i], width));
+        return Ranking::lex_rank(cells, k, width * width);
+    }
+};
+
+
+#endif //PATTERNHEURISTIC_H
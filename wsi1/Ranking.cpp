@@ -0,0 +1,116 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "Ranking.h"
+#include <stdexcept>
+
+
+uint64_t Ranking::count(int n, int k) {
+    uint64_t result = 1;
+    for (int i = 0; i < k; i++) result *= static_cast<uint64_t>(n - i);
+    return result;
+}
+
+uint64_t Ranking::lex_rank(const char* sequence, int k, int n) {
+    uint64_t rank = 0;
+    uint64_t used = 0;
+    for (int i = 0; i < k; i++) {
+        int value = sequence[i];
+        // smaller values that are still unused = the digit in the factorial number system
+        int digit = value - popcount(used & ((uint64_t(1) << value) - 1));
+        rank = rank * static_cast<uint64_t>(n - i) + static_cast<uint64_t>(digit);
+        used |= uint64_t(1) << value;
+    }
+    return rank;
+}
+
+void Ranking::lex_unrank(uint64_t rank, int k, int n, char* sequence) {
+    int digits[max_elements];
+    for (int i = k - 1; i >= 0; i--) {
+        digits[i] = static_cast<int>(rank % static_cast<uint64_t>(n - i));
+        rank /= static_cast<uint64_t>(n - i);
+    }
+
+    uint64_t free_values = (n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1);
+    for (int i = 0; i < k; i++) {
+        uint64_t candidates = free_values;
+        for (int skip = digits[i]; skip > 0; skip--) candidates &= candidates - 1; // drop the lowest free values
+        uint64_t chosen = candidates & (~candidates + 1);
+        sequence[i] = static_cast<char>(popcount(chosen - 1));
+        free_values &= ~chosen;
+    }
+}
+
+// The sequence is placed at the end of a permutation of 0..n-1, the k steps of
+// Myrvold and Ruskey's rank1 that follow only ever look at those positions.
+uint64_t Ranking::mr_rank(const char* sequence, int k, int n) {
+    char permutation[max_elements], inverse[max_elements];
+    bool placed[max_elements] = {};
+    for (int i = 0; i < k; i++) {
+        permutation[n - k + i] = sequence[i];
+        placed[static_cast<int>(sequence[i])] = true;
+    }
+    for (int value = 0, position = 0; value < n; value++) {
+        if (!placed[value]) permutation[position++] = static_cast<char>(value);
+    }
+    for (int position = 0; position < n; position++) {
+        inverse[static_cast<int>(permutation[position])] = static_cast<char>(position);
+    }
+
+    uint64_t rank = 0, weight = 1;
+    for (int m = n; m > n - k; m--) {
+        int s = permutation[m - 1];
+        int where = inverse[m - 1];
+        permutation[m - 1] = static_cast<char>(m - 1);
+        permutation[where] = static_cast<char>(s);
+        inverse[s] = static_cast<char>(where);
+        inverse[m - 1] = static_cast<char>(m - 1);
+        rank += static_cast<uint64_t>(s) * weight;
+        weight *= static_cast<uint64_t>(m);
+    }
+    return rank;
+}
+
+void Ranking::mr_unrank(uint64_t rank, int k, int n, char* sequence) {
+    char permutation[max_elements];
+    for (int i = 0; i < n; i++) permutation[i] = static_cast<char>(i);
+    for (int m = n; m > n - k; m--) {
+        int s = static_cast<int>(rank % static_cast<uint64_t>(m));
+        rank /= static_cast<uint64_t>(m);
+        char keep = permutation[m - 1];
+        permutation[m - 1] = permutation[s];
+        permutation[s] = keep;
+    }
+    for (int i = 0; i < k; i++) sequence[i] = permutation[n - k + i];
+}
+
+void Ranking::pattern_cells(const char* game_state, int n, const char* pattern, int k, char* cells) {
+    char where[max_elements];
+    for (int cell = 0; cell < n; cell++) where[static_cast<int>(game_state[cell])] = static_cast<char>(cell);
+    for (int i = 0; i < k; i++) cells[i] = where[static_cast<int>(pattern[i])];
+}
+
+void Ranking::lex_rank_batch(const char* sequences, size_t count, int k, int n, uint64_t* ranks) {
+    for (size_t i = 0; i < count; i++) ranks[i] = lex_rank(sequences + i * k, k, n);
+}
+
+void Ranking::lex_unrank_batch(const uint64_t* ranks, size_t count, int k, int n, char* sequences) {
+    for (size_t i = 0; i < count; i++) lex_unrank(ranks[i], k, n, sequences + i * k);
+}
+
+void Ranking::mr_rank_batch(const char* sequences, size_t count, int k, int n, uint64_t* ranks) {
+    for (size_t i = 0; i < count; i++) ranks[i] = mr_rank(sequences + i * k, k, n);
+}
+
+void Ranking::mr_unrank_batch(const uint64_t* ranks, size_t count, int k, int n, char* sequences) {
+    for (size_t i = 0; i < count; i++) mr_unrank(ranks[i], k, n, sequences + i * k);
+}
+
+void Ranking::pattern_rank_batch(const char* boards, size_t count, int n, const char* pattern, int k, uint64_t* ranks) {
+    char cells[max_elements];
+    for (size_t i = 0; i < count; i++) {
+        pattern_cells(boards + i * n, n, pattern, k, cells);
+        ranks[i] = lex_rank(cells, k, n);
+    }
+}
@@ -0,0 +1,65 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef RANKING_H
+#define RANKING_H
+#include <cstdint>
+#include <cstddef>
+
+
+// Maps (partial) permutations to dense integer indices and back - the indexing
+// core of every table in the project.
+//
+// A partial permutation is a sequence of k distinct values taken from 0..n-1
+// (for example the cells occupied by the k tiles of a pattern), it gets an
+// index in [0, n! / (n - k)!). A full permutation is the case k = n.
+// Everything works for n <= 64 as long as n! / (n - k)! fits into 64 bits
+// (any full permutation of up to 20 elements, or e.g. 7 tiles on a 5x5 board).
+//
+// Two orders are provided:
+//  - lexicographic: indices follow the order of the sequences, ranking counts
+//    the smaller unused values with a popcount over a bitmask of used values,
+//  - Myrvold-Ruskey: a different order, but ranking and unranking are both
+//    strictly linear and need no bit tricks.
+class Ranking {
+public:
+    static constexpr int max_elements = 64;
+
+    static inline int popcount(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_popcountll(bits);
+#else
+        int count = 0;
+        for (; bits; bits &= bits - 1) count++;
+        return count;
+#endif
+    }
+
+    // n! / (n - k)!
+    static uint64_t count(int n, int k);
+
+    static uint64_t lex_rank(const char* sequence, int k, int n);
+    static void lex_unrank(uint64_t rank, int k, int n, char* sequence);
+    static uint64_t lex_rank(const char* permutation, int n) { return lex_rank(permutation, n, n); }
+    static void lex_unrank(uint64_t rank, int n, char* permutation) { lex_unrank(rank, n, n, permutation); }
+
+    static uint64_t mr_rank(const char* sequence, int k, int n);
+    static void mr_unrank(uint64_t rank, int k, int n, char* sequence);
+    static uint64_t mr_rank(const char* permutation, int n) { return mr_rank(permutation, n, n); }
+    static void mr_unrank(uint64_t rank, int n, char* permutation) { mr_unrank(rank, n, n, permutation); }
+
+    // cells of the given tiles on a board of n cells, i.e. the partial permutation a pattern database indexes by
+    static void pattern_cells(const char* game_state, int n, const char* pattern, int k, char* cells);
+
+    //// batched forms - `count` sequences of k values stored back to back
+    static void lex_rank_batch(const char* sequences, size_t count, int k, int n, uint64_t* ranks);
+    static void lex_unrank_batch(const uint64_t* ranks, size_t count, int k, int n, char* sequences);
+    static void mr_rank_batch(const char* sequences, size_t count, int k, int n, uint64_t* ranks);
+    static void mr_unrank_batch(const uint64_t* ranks, size_t count, int k, int n, char* sequences);
+    // pattern indices (lexicographic) of `count` boards of n cells stored back to back
+    static void pattern_rank_batch(const char* boards, size_t count, int n, const char* pattern, int k, uint64_t* ranks);
+};
+
+
+#endif //RANKING_H
@@ -0,0 +1,36 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef SOLUTION_H
+#define SOLUTION_H
+#include <vector>
+#include <algorithm>
+#include "MoveString.h"
+
+
+// What a solve leaves behind: the start permutation plus the blank moves.
+// Boards along the path are not kept, board_after() replays them on demand.
+struct Solution {
+    int width = 0;
+    std::vector<char> start_state;
+    MoveString moves;
+    unsigned long long nodes_expanded = 0;
+
+    Solution() = default;
+    Solution(const char* game_state, int _width) : width(_width), start_state(game_state, game_state + _width * _width) {}
+
+    size_t length() const { return moves.size(); }
+
+    // fills game_state with the board reached after the first `step` moves
+    void board_after(size_t step, char* game_state) const {
+        std::copy(start_state.begin(), start_state.end(), game_state);
+        int blank = static_cast<int>(std::find(start_state.begin(), start_state.end(), 0) - start_state.begin());
+        for (size_t i = 0; i < step && i < moves.size(); i++) {
+            blank = MoveString::apply(game_state, width, blank, moves[i]);
+        }
+    }
+};
+
+
+#endif //SOLUTION_H
@@ -0,0 +1,212 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "SolutionCache.h"
+#include "Symmetry.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <filesystem>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/file.h>
+#define WSI_HAVE_FLOCK 1
+#endif
+
+static const char cache_magic[4] = {'W', 'S', 'I', 'C'};
+static const size_t header_size = 8;
+static const size_t record_header_size = 10; // u64 key + u16 length
+
+
+SolutionCache::SolutionCache(int _width, const std::string& _path, size_t _lru_capacity) {
+    if (_width * _width > 16) {
+        throw std::invalid_argument("solution cache keys only fit boards up to 4x4");
+    }
+    width = _width;
+    path = _path;
+    lru_capacity = std::max<size_t>(_lru_capacity, 1);
+    if (!path.empty()) load_index();
+}
+
+SolutionCache::key_type SolutionCache::pack(const char* game_state) const {
+    key_type packed = 0;
+    for (int i = 0; i < width * width; i++) {
+        packed |= static_cast<key_type>(game_state[i]) << (4 * i);
+    }
+    return packed;
+}
+
+SolutionCache::key_type SolutionCache::canonical_key(const char* game_state, bool& mirrored) const {
+    char reflection[16];
+    Symmetry::mirror(game_state, reflection, width);
+    key_type direct = pack(game_state), reflected = pack(reflection);
+    mirrored = reflected < direct;
+    return mirrored ? reflected : direct;
+}
+
+// serializes appends between processes sharing the cache file, where flock is available
+static void lock_file(std::FILE* file, bool exclusive) {
+#ifdef WSI_HAVE_FLOCK
+    flock(fileno(file), exclusive ? LOCK_EX : LOCK_UN);
+#else
+    (void) file;
+    (void) exclusive;
+#endif
+}
+
+// fclose()s the file either way, false when a write or the close failed
+static bool close_written(std::FILE* file) {
+    bool written = std::ferror(file) == 0 && std::fflush(file) == 0;
+    lock_file(file, false);
+    return std::fclose(file) == 0 && written;
+}
+
+void SolutionCache::load_index() {
+    namespace fs = std::filesystem;
+    if (!fs::exists(path)) {
+        //// "x" fails instead of truncating when another process created the cache meanwhile
+        std::FILE* file = std::fopen(path.c_str(), "wbx");
+        if (file == nullptr && !fs::exists(path)) {
+            throw std::runtime_error("cannot create solution cache " + path);
+        }
+        if (file != nullptr) {
+            uint32_t stored_width = static_cast<uint32_t>(width);
+            std::fwrite(cache_magic, 1, 4, file);
+            std::fwrite(&stored_width, sizeof(stored_width), 1, file);
+            if (!close_written(file)) {
+                throw std::runtime_error("cannot write solution cache " + path);
+            }
+        }
+    }
+    if (fs::file_size(path) < header_size) {
+        throw std::runtime_error(path + " is not a solution cache for this board size");
+    }
+
+    mapped.open(path);
+    const unsigned char* data = mapped.data();
+    uint32_t stored_width = 0;
+    std::memcpy(&stored_width, data + 4, sizeof(stored_width));
+    if (std::memcmp(data, cache_magic, 4) != 0 || stored_width != static_cast<uint32_t>(width)) {
+        throw std::runtime_error(path + " is not a solution cache for this board size");
+    }
+
+    size_t offset = index_records(header_size);
+
+    //// a crash in the middle of an append leaves a torn record behind; under the lock, so not one being written now
+    if (offset != mapped.size()) {
+        std::FILE* file = std::fopen(path.c_str(), "r+b");
+        if (file == nullptr) {
+            throw std::runtime_error("cannot repair solution cache " + path);
+        }
+        lock_file(file, true);
+        mapped.remap();
+        offset = index_records(offset);
+        if (offset != mapped.size()) {
+            mapped.close();
+            fs::resize_file(path, offset);
+            mapped.open(path);
+        }
+        lock_file(file, false);
+        std::fclose(file);
+    }
+}
+
+size_t SolutionCache::index_records(size_t offset) {
+    const unsigned char* data = mapped.data();
+    while (offset + record_header_size <= mapped.size()) {
+        key_type key;
+        uint16_t length;
+        std::memcpy(&key, data + offset, sizeof(key));
+        std::memcpy(&length, data + offset + 8, sizeof(length));
+        size_t record_size = record_header_size + (length + 3) / 4;
+        if (offset + record_size > mapped.size()) break;
+        file_index[key] = offset;
+        offset += record_size;
+    }
+    return offset;
+}
+
+void SolutionCache::remember(key_type key, const MoveString& moves) {
+    auto found = lru_index.find(key);
+    if (found != lru_index.end()) {
+        lru.splice(lru.begin(), lru, found->second);
+        return;
+    }
+    lru.push_front(entry{key, moves});
+    lru_index[key] = lru.begin();
+    if (lru.size() > lru_capacity) {
+        lru_index.erase(lru.back().key);
+        lru.pop_back();
+    }
+}
+
+bool SolutionCache::lookup(const char* game_state, MoveString& moves) {
+    bool mirrored;
+    key_type key = canonical_key(game_state, mirrored);
+    std::lock_guard<std::mutex> lock(guard);
+
+    auto cached = lru_index.find(key);
+    if (cached != lru_index.end()) {
+        lru.splice(lru.begin(), lru, cached->second);
+        moves = cached->second->moves;
+    } else {
+        auto stored = file_index.find(key);
+        if (stored == file_index.end()) {
+            misses++;
+            return false;
+        }
+        size_t offset = stored->second;
+        if (offset + record_header_size > mapped.size()) mapped.remap(); // appended after mapping
+        key_type stored_key = 0;
+        uint16_t length = 0;
+        if (offset + record_header_size <= mapped.size()) {
+            std::memcpy(&stored_key, mapped.data() + offset, sizeof(stored_key));
+            std::memcpy(&length, mapped.data() + offset + 8, sizeof(length));
+            if (offset + record_header_size + (length + 3) / 4 > mapped.size()) mapped.remap();
+        }
+        //// the file shrank or the record at the offset is not this board's: a miss, not a crash
+        if (stored_key != key || offset + record_header_size + (length + 3) / 4 > mapped.size()) {
+            file_index.erase(stored);
+            misses++;
+            return false;
+        }
+        moves = MoveString::from_bytes(mapped.data() + stored->second + record_header_size, length);
+        remember(key, moves);
+    }
+
+    if (mirrored) moves = Symmetry::mirror_moves(moves);
+    hits++;
+    return true;
+}
+
+void SolutionCache::insert(const char* game_state, const MoveString& moves) {
+    bool mirrored;
+    key_type key = canonical_key(game_state, mirrored);
+    MoveString canonical_moves = mirrored ? Symmetry::mirror_moves(moves) : moves;
+    std::lock_guard<std::mutex> lock(guard);
+
+    if (!path.empty() && !file_index.count(key)) {
+        //// not "ab": the offset taken at the end must be where the record lands, so no other writer in between
+        std::FILE* file = std::fopen(path.c_str(), "r+b");
+        if (file == nullptr) {
+            throw std::runtime_error("cannot append to solution cache " + path);
+        }
+        lock_file(file, true);
+        std::fseek(file, 0, SEEK_END);
+        long offset = std::ftell(file);
+        uint16_t length = static_cast<uint16_t>(canonical_moves.size());
+        const auto& bytes = canonical_moves.bytes();
+        std::vector<unsigned char> record(record_header_size + bytes.size());
+        std::memcpy(record.data(), &key, sizeof(key));
+        std::memcpy(record.data() + 8, &length, sizeof(length));
+        std::copy(bytes.begin(), bytes.end(), record.begin() + record_header_size);
+        std::fwrite(record.data(), 1, record.size(), file);
+        if (!close_written(file) || offset < 0) {
+            throw std::runtime_error("cannot append to solution cache " + path);
+        }
+        file_index[key] = static_cast<size_t>(offset);
+    }
+    remember(key, canonical_moves);
+}
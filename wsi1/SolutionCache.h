@@ -0,0 +1,65 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef SOLUTIONCACHE_H
+#define SOLUTIONCACHE_H
+#include <cstdint>
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include "MappedFile.h"
+#include "MoveString.h"
+
+
+// Optimal move strings of already solved start permutations.
+//
+// Lookups go through an in-process LRU first and then through an index over
+// an append-only cache file that is memory-mapped for reading. Processes may
+// share the file: appends take an flock, and a record whose key does not
+// match the board looked up counts as a miss.
+//   header: "WSIC", u32 width
+//   record: u64 key, u16 length, ceil(length / 4) MoveString bytes
+// A board and its reflection across the main diagonal (see Symmetry) share a
+// single entry, keyed by the smaller of the two packed boards.
+class SolutionCache {
+public:
+    typedef uint64_t key_type;
+
+    // path may be empty for a purely in-memory cache
+    SolutionCache(int width, const std::string& path, size_t lru_capacity = 1 << 16);
+    SolutionCache(const SolutionCache&) = delete;
+    SolutionCache& operator=(const SolutionCache&) = delete;
+
+    bool lookup(const char* game_state, MoveString& moves);
+    void insert(const char* game_state, const MoveString& moves);
+
+    size_t get_hits() const { return hits; }
+    size_t get_misses() const { return misses; }
+
+private:
+    struct entry {
+        key_type key;
+        MoveString moves;
+    };
+
+    int width;
+    std::string path;
+    size_t lru_capacity;
+    std::list<entry> lru;
+    std::unordered_map<key_type, std::list<entry>::iterator> lru_index;
+    std::unordered_map<key_type, size_t> file_index; // key -> record offset in the file
+    MappedFile mapped;
+    std::mutex guard;
+    size_t hits = 0, misses = 0;
+
+    key_type pack(const char* game_state) const;
+    key_type canonical_key(const char* game_state, bool& mirrored) const;
+    void load_index();
+    size_t index_records(size_t offset); // the complete records from offset on, returns where they end
+    void remember(key_type key, const MoveString& moves);
+};
+
+
+#endif //SOLUTIONCACHE_H
@@ -1,293 +1,733 @@
-//
-// Created by adame on 4/4/2023.
-
-#include "Solver.h"
-
-
-
-const std::vector<Solver::Node::direction> Solver::Node::all_directions = {Solver::Node::direction::up, Solver::Node::direction::down, Solver::Node::direction::left, Solver::Node::direction::right};
-
-
-Solver::Solver(char* _init_state) noexcept {
-    solution.clear();
-    init_state = _init_state;
-}
-
-std::vector<Solver::Node*> Solver::solve() {
-    if (solution.empty()) solution = Solver::find_feasible_solution();
-    return solution;
-}
-
-bool Solver::is_solvable(Node* game_node) {
-    int num_of_inversions = 0;
-    for ( int i = 0 ; i < Node::grid_size * Node::grid_size ; i++ )
-        for ( int j = i+1 ; j < Node::grid_size * Node::grid_size ; j++ ) {
-            if (game_node->game_state[i] == 0 || game_node->game_state[j] == 0)
-                continue;
-            if (game_node->game_state[i] > game_node->game_state[j])
-                num_of_inversions++;
-        }
-
-    Node::Point blank = Node::to_coordinate(game_node->current);
-//        int manhattan_distance_between_blank_and_top_left_corner = blank.x + blank.y;
-
-    return ((num_of_inversions + blank.y) % 2 == 1);
-}
-
-std::vector<Solver::Node*> Solver::find_feasible_solution(){
-    //// setup
-    int num_of_iterations = 0;
-    Node* base_node = new Node(init_state);
-
-    if ( !is_solvable(base_node) ) {
-        delete base_node;
-        throw std::runtime_error("given starting permutation is not solvable!\n");
-    }
-
-    //// begin A*
-    open.push(base_node);
-    std::vector<Node*> feasible_solutions;
-    short current_min_val = INT16_MAX;
-
-    std::ofstream result_dump("../algorithm_logs.txt");
-
-    while (!open.empty()) {
-
-        num_of_iterations++;
-        auto* current_node = open.top();
-        open.pop();
-        visited.insert(current_node);
-
-        if (current_min_val < current_node->f_cost - 1) {
-            continue;
-        }
-
-        result_dump << "\n";
-        result_dump << "current_node->h_cost " << current_node->h_cost << "\n";
-        result_dump << "current_node->g_cost " << current_node->g_cost << "\n";
-        result_dump << "current_node->f_cost " << current_node->f_cost << "\n";
-        result_dump << "\n";
-
-
-        if (current_node->get_heuristic_cost() == 0) {
-            bool feasible = true;
-            for (int i = 0 ; i < Node::grid_size * Node::grid_size - 1; i++) {
-                if (current_node->game_state[i] != static_cast<char>(i+1)) {
-                    feasible = false;
-                    break;
-                }
-            }
-            if (feasible){
-                feasible_solutions.push_back(current_node);
-                current_min_val = std::min(current_min_val, current_node->get_distance_cost());
-
-                auto finish = std::chrono::high_resolution_clock::now();
-                std::cout<<"i found a solution candidate! distance:" << current_node->g_cost <<"\n";
-            }
-        }
-
-
-        for (int direction : Solver::Node::all_directions) {
-            if (current_node->get_direction_towards_parent() == direction) {
-                continue;
-            }
-
-            Node* new_node;
-            try {
-                new_node = Node::create_new_node(current_node, direction);
-            }
-            catch (const std::invalid_argument & e) {
-//                std::cout << "couldnt make new node\n";
-                continue;
-            }
-
-            if (visited.count(new_node)){
-                auto visited_node_pointer = visited.find(new_node);
-                if( (*visited_node_pointer)->g_cost <= new_node->get_distance_cost() ) {
-                    delete new_node;
-                    continue;
-                }
-                visited.erase(visited_node_pointer);
-                delete *visited_node_pointer;
-                visited.insert(new_node);
-            }
-            open.push(new_node);
-        }
-    }
-    return feasible_solutions;
-}
-
-
-Solver::~Solver() {
-    for ( auto* node : visited ) {
-        delete node;
-    }
-}
-
-bool Solver::is_valid_move(int origin, int destination){
-    return destination >= 0
-           && destination < Node::grid_size * Node::grid_size
-           && (abs((destination % Node::grid_size) - (origin % Node::grid_size)) == 1 || abs(destination - origin) != 1);
-}
-
-int Solver::find_current_blank_space_index(const char* game_state) {
-    int current = -1;
-    for (int i = 0; i < Node::grid_size * Node::grid_size; ++i ) {
-        if (game_state[i] == 0){
-            current = i;
-            break;
-        }
-    }
-    if (current == -1) {
-        throw std::invalid_argument("game_state is invalid, no blank space found!");
-    }
-
-    return current;
-}
-
-short Solver::heuristic_function_manhattan_with_linear_conflict(char* game_state) {
-    int sum = 0;
-    for ( int i = 0 ; i < Node::grid_size*Node::grid_size ; i++ ) {
-        if ( game_state[i] == 0 ) {
-            continue; // ignonre blank space
-        }
-        Node::Point current_coordinate = Node::to_coordinate(i);
-        Node::Point destination_coordinate = Node::to_coordinate(game_state[i] - 1); // game_state includes value from 1 to grid_size^2 not - to grid_size^2 - 1
-        sum +=  abs(current_coordinate.x - destination_coordinate.x)
-                + abs(current_coordinate.y - destination_coordinate.y); // manhattan distance
-    }
-    sum /= 2;
-
-    for ( int row = 0 ; row < Node::grid_size*Node::grid_size ; row+=Node::grid_size) {
-        for ( int i = 0 ; i < Node::grid_size ; i++) {
-            for ( int j = i + 1 ; j < Node::grid_size ; j++) {
-                if (row < game_state[row + i] < row + Node::grid_size && row < game_state[row + j] < row + Node::grid_size && game_state[row + i] > game_state[row + j])
-                    sum+=2;
-            }
-        }
-    }
-
-    for ( int column = 0 ; column < Node::grid_size ; column++) {
-        for ( int i = 0 ; i < Node::grid_size * Node::grid_size ; i += Node::grid_size ) {
-            for ( int j = i + Node::grid_size ; j < Node::grid_size * Node::grid_size ; j += Node::grid_size ) {
-                if (game_state[column + i] % Node::grid_size == column == game_state[column + j] % Node::grid_size && game_state[column + i] > game_state[column + j])
-                    sum+=2;
-            }
-        }
-    }
-    return static_cast<short>(sum);
-}
-
-short Solver::heuristic_function_manhattan(char* game_state) {
-    int sum = 0;
-    for ( int i = 0 ; i < Solver::Node::grid_size*Solver::Node::grid_size ; i++ ) {
-        if ( game_state[i] == 0 ) {
-            continue; // ignonre blank space
-        }
-        Node::Point current_coordinate = Node::to_coordinate(i);
-        Node::Point destination_coordinate = Node::to_coordinate(game_state[i] - 1); // game_state includes value from 1 to grid_size^2 not - to grid_size^2 - 1
-        sum +=  abs(current_coordinate.x - destination_coordinate.x)
-                + abs(current_coordinate.y - destination_coordinate.y); // manhattan distance
-    }
-    return static_cast<short>((sum) / 2);
-}
-
-short Solver::heuristic_function_walking_distance(char* game_state, int current) {
-    int result_sum = 0;
-    if (current == -1) {
-        current = find_current_blank_space_index(game_state);
-    }
-    Node::Point current_blank_coordinate = Node::to_coordinate(current);
-
-    for ( int i = 0 ; i < Node::grid_size * Node::grid_size ; i++ ) {
-
-        if ( i == current ) {
-            continue; // omit blank space
-        }
-
-        Node::Point source_coordinate = Node::to_coordinate(i);
-        Node::Point destination_coordinate = Node::to_coordinate(static_cast<int>(game_state[i] - 1)); //minus one since game_state values begin at 1 not 0
-        int vertical_distance = std::abs(destination_coordinate.y - source_coordinate.y);
-        int horizontal_distance = std::abs(destination_coordinate.x - source_coordinate.x);
-
-        if ( vertical_distance != 0 ) {
-            result_sum += vertical_distance * 3;
-            +std::abs(source_coordinate.y - current_blank_coordinate.y);
-            if ((destination_coordinate.y - current_blank_coordinate.y)*(destination_coordinate.y - source_coordinate.y) < 0)
-                if (std::abs(destination_coordinate.y - current_blank_coordinate.y) >= vertical_distance )
-                    result_sum += 2;
-
-        }
-        if ( horizontal_distance != 0 ) {
-            result_sum += horizontal_distance * 3;
-            + std::abs(source_coordinate.x - current_blank_coordinate.x);
-            if ((destination_coordinate.x - current_blank_coordinate.x)*(destination_coordinate.x - source_coordinate.x) > 0)
-                if (std::abs(destination_coordinate.x - current_blank_coordinate.x) >= horizontal_distance )
-                    result_sum += 2;
-        }
-    }
-
-//    return static_cast<short>((result_sum - 1) / 2 + 1);
-    return static_cast<short>(result_sum / 2);
-}
-
-
-
-short Solver::heuristic_function_inversion_distance(const char* game_state) {
-    int num_of_inversions = 0;
-    for ( int i = 0 ; i < Node::grid_size * Node::grid_size ; i++ )
-        for ( int j = i+1 ; j < Node::grid_size * Node::grid_size ; j++ ) {
-            if (game_state[i] == 0 || game_state[j] == 0)
-                continue;
-            if (game_state[i] > game_state[j])
-                num_of_inversions++;
-        }
-
-//        int manhattan_distance_between_blank_and_top_left_corner = blank.x + blank.y;
-
-    return std::ceil(num_of_inversions / 3.0);
-
-}
-
-
-int Solver::do_move(char* game_state, int direction) {
-    int current = find_current_blank_space_index(game_state);
-    return do_move(game_state, direction, current);
-}
-
-// returns current index of 0 in the puzzle
-int Solver::do_move(char* game_state, int direction, int current){
-
-    int destination = current + direction;
-
-    if (!is_valid_move(current, destination)){
-        throw std::invalid_argument("invalid move direction");
-    }
-
-    game_state[current] = game_state[destination];
-    game_state[destination] = 0;
-    current = destination;
-
-    return current;
-}
-
-
-bool Solver::Compare::operator()(Solver::Node *a, Solver::Node *b) {
-    if (a->f_cost > b->f_cost) {
-        return true;
-    } else if (a->f_cost == b->f_cost && a->h_cost > b->h_cost) {
-        return true;
-    }
-    return false;
-}
-
-
-
-size_t Solver::game_state_hasher::operator()(const Node *node) const {
-    std::hash<char> hasher;
-    size_t seed = 0;
-    for (int i = 0 ; i < Node::grid_size * Node::grid_size; i++) {
-        seed ^= hasher(node->game_state[i]) + 0x9e3779b9 + (seed<<6) + (seed>>2);
-    }
-    return seed;
+//
+// Created by adame on 4/4/2023.
+
+#include <climits>
+#include <memory>
+#include <unordered_map>
+#include "Solver.h"
+#include "BeamSearch.h"
+#include "EndgameTable.h"
+#include "HeuristicRegistry.h"
+#include "Inversions.h"
+#include "OperatorDeltas.h"
+
+
+
+const std::vector<Solver::Node::direction> Solver::Node::all_directions = {Solver::Node::direction::up, Solver::Node::direction::down, Solver::Node::direction::left, Solver::Node::direction::right};
+
+
+Solver::Solver(char* _init_state, std::string _heuristic) noexcept {
+    init_state = _init_state;
+    heuristic = std::move(_heuristic);
+}
+
+Solution Solver::solve() {
+    if (solved) return solution;
+
+    Solution result(init_state, Node::grid_size);
+    if (beam_width > 0) {
+        std::unique_ptr<char[]> start_state(init_state); // no base node to own it in this mode
+        init_state = nullptr;
+        result = HeuristicRegistry::dispatch<Node::grid_size>(heuristic, [this, &start_state](const auto& estimator) {
+            BeamSearch<Node::grid_size, std::decay_t<decltype(estimator)>> beam(estimator, beam_width);
+            beam.set_restarts(beam_restarts);
+            return beam.solve(start_state.get());
+        });
+        nodes_expanded = result.nodes_expanded;
+        solution = result;
+        solved = true;
+        return solution;
+    }
+    if (frontier || breadth_first) {
+        result.moves = HeuristicRegistry::dispatch<Node::grid_size>(heuristic, [this](const auto& estimator) {
+            return breadth_first ? find_breadth_first_solution(estimator) : find_frontier_solution(estimator);
+        });
+        result.nodes_expanded = nodes_expanded;
+        solution = result;
+        solved = true;
+        return solution;
+    }
+    std::vector<Node*> feasible_solutions = HeuristicRegistry::dispatch<Node::grid_size>(
+            heuristic, [this](const auto& estimator) {
+                return partial_expansion ? find_partial_expansion_solution(estimator) : find_feasible_solution(estimator);
+            });
+
+    Node* best = nullptr;
+    for (auto* candidate : feasible_solutions) {
+        if (best == nullptr || candidate->g_cost < best->g_cost) best = candidate;
+    }
+    for (Node* node = best; node != nullptr && node->parent != nullptr; node = node->parent) {
+        result.moves.push_back(MoveString::from_offset(node->current - node->parent->current, Node::grid_size));
+    }
+    result.moves.reverse();
+    result.nodes_expanded = nodes_expanded;
+
+    release_search_memory(); // note: init_state is owned (and freed) by the base node
+    solution = result;
+    solved = true;
+    return solution;
+}
+
+void Solver::release_search_memory() {
+    for ( auto* node : visited ) {
+        delete node;
+    }
+    visited.clear();
+    while (!open.empty()) {
+        delete open.top();
+        open.pop();
+    }
+}
+
+bool Solver::is_solvable(Node* game_node) {
+    return Inversions::is_solvable(game_node->game_state, Node::grid_size);
+}
+
+template<class Heuristic>
+short Solver::estimate(const Heuristic& estimator, char* game_state) const {
+    auto value = static_cast<short>(Heuristic::cost(estimator.evaluate(game_state)));
+    if (endgame_table == nullptr) return value;
+    // an admissible estimate above the radius already places the board outside
+    if (!Heuristic::is_admissible || value <= endgame_table->get_radius()) {
+        int exact = endgame_table->distance(EndgameTable::Packed::pack(game_state));
+        if (exact >= 0) return static_cast<short>(exact);
+    }
+
+    if (value <= endgame_table->get_radius() + 1) {
+        // not in the table means farther than its radius, by a number of moves of the blank's parity
+        int blank = find_current_blank_space_index(game_state);
+        int rim = endgame_table->get_radius() + 1;
+        rim += (rim + blank % Node::grid_size + blank / Node::grid_size) % 2;
+        value = std::max(value, static_cast<short>(rim));
+    }
+    return value;
+}
+
+template<class Heuristic>
+Solver::Node* Solver::create_child(Node* parent, int direction, const Heuristic& estimator) const {
+    if (!Solver::is_valid_move(parent->current, parent->current + direction)) {
+        return nullptr;
+    }
+    char* game_state = new char[Node::grid_size * Node::grid_size];
+    std::memcpy(game_state, parent->game_state, Node::grid_size * Node::grid_size);
+    int current = Solver::do_move(game_state, direction, parent->current);
+    return new Node(game_state, parent, current, estimate(estimator, game_state));
+}
+
+Solver::Node* Solver::create_child(Node* parent, int direction, short h_cost) {
+    char* game_state = new char[Node::grid_size * Node::grid_size];
+    std::memcpy(game_state, parent->game_state, Node::grid_size * Node::grid_size);
+    int current = Solver::do_move(game_state, direction, parent->current);
+    return new Node(game_state, parent, current, h_cost);
+}
+
+template<class Heuristic>
+void Solver::child_estimates(const Heuristic& estimator, const Node* node, int estimates[4]) const {
+    char game_state[Node::grid_size * Node::grid_size];
+    std::memcpy(game_state, node->game_state, Node::grid_size * Node::grid_size);
+    if (endgame_table == nullptr) {
+        OperatorDeltas<Node::grid_size, Heuristic>::children(estimator, game_state, node->current, node->h_cost, estimates);
+        return;
+    }
+    // the table overrides the estimate, every child is looked up on its own
+    for (int move = MoveString::up; move <= MoveString::right; move++) {
+        if (!blank_can_move<Node::grid_size>(node->current, move)) {
+            estimates[move] = -1;
+            continue;
+        }
+        int blank = MoveString::apply(game_state, Node::grid_size, node->current, move);
+        estimates[move] = estimate(estimator, game_state);
+        MoveString::apply(game_state, Node::grid_size, blank, MoveString::inverse(move));
+    }
+}
+
+template<class Heuristic>
+std::vector<Solver::Node*> Solver::find_feasible_solution(const Heuristic& estimator){
+    //// setup
+    nodes_expanded = 0;
+    nodes_generated = 0;
+    Node* base_node = new Node(init_state, nullptr, find_current_blank_space_index(init_state), estimate(estimator, init_state));
+
+    if ( !is_solvable(base_node) ) {
+        delete base_node;
+        throw std::runtime_error("given starting permutation is not solvable!\n");
+    }
+
+    //// begin A*
+    open.push(base_node);
+    std::vector<Node*> feasible_solutions;
+    short current_min_val = INT16_MAX;
+
+    std::ofstream result_dump;
+    if (verbose) result_dump.open("../algorithm_logs.txt");
+
+    while (!open.empty()) {
+
+        nodes_expanded++;
+        auto* current_node = open.top();
+        open.pop();
+        visited.insert(current_node);
+
+        if (current_min_val < current_node->f_cost - 1) {
+            continue;
+        }
+
+        if (verbose) {
+            result_dump << "\n";
+            result_dump << "current_node->h_cost " << current_node->h_cost << "\n";
+            result_dump << "current_node->g_cost " << current_node->g_cost << "\n";
+            result_dump << "current_node->f_cost " << current_node->f_cost << "\n";
+            result_dump << "\n";
+        }
+
+
+        if (endgame_table != nullptr) {
+            auto packed = EndgameTable::Packed::pack(current_node->game_state);
+            if (endgame_table->distance(packed) >= 0) {
+                //// the rest of the path is read off the table
+                Node* node = current_node;
+                MoveString rest = endgame_table->finish(packed);
+                for (size_t i = 0; i < rest.size(); i++) {
+                    node = create_child(node, MoveString::offset(rest[i], Node::grid_size), estimator);
+                    visited.insert(node);
+                }
+                feasible_solutions.push_back(node);
+                return feasible_solutions;
+            }
+        }
+
+        if (current_node->get_heuristic_cost() == 0) {
+            bool feasible = true;
+            for (int i = 0 ; i < Node::grid_size * Node::grid_size - 1; i++) {
+                if (current_node->game_state[i] != static_cast<char>(i+1)) {
+                    feasible = false;
+                    break;
+                }
+            }
+            if (feasible){
+                feasible_solutions.push_back(current_node);
+                current_min_val = std::min(current_min_val, current_node->get_distance_cost());
+
+                auto finish = std::chrono::high_resolution_clock::now();
+                if (verbose) std::cout<<"i found a solution candidate! distance:" << current_node->g_cost <<"\n";
+            }
+        }
+
+
+        for (int direction : Solver::Node::all_directions) {
+            if (current_node->get_direction_towards_parent() == direction) {
+                continue;
+            }
+
+            Node* new_node = create_child(current_node, direction, estimator);
+            if (new_node == nullptr) {
+                continue;
+            }
+            nodes_generated++;
+
+            if (visited.count(new_node)){
+                auto visited_node_pointer = visited.find(new_node);
+                if( (*visited_node_pointer)->g_cost <= new_node->get_distance_cost() ) {
+                    delete new_node;
+                    continue;
+                }
+                visited.erase(visited_node_pointer);
+                delete *visited_node_pointer;
+                visited.insert(new_node);
+            }
+            open.push(new_node);
+        }
+    }
+    return feasible_solutions;
+}
+
+// Enhanced partial expansion A*. A node in the queue carries F, the f of the
+// children it still has to build, starting at its own f. Expanding it builds
+// only the children with f == F (and on the first expansion those below F,
+// which an inconsistent estimate allows), then the node goes back into the
+// queue with the smallest f above F or is closed when no child is left. The
+// estimates of the children come from OperatorDeltas, so a child that is
+// never built costs neither an allocation nor (for Manhattan) an evaluation.
+template<class Heuristic>
+std::vector<Solver::Node*> Solver::find_partial_expansion_solution(const Heuristic& estimator) {
+    //// setup
+    nodes_expanded = 0;
+    nodes_generated = 0;
+    Node* base_node = new Node(init_state, nullptr, find_current_blank_space_index(init_state), estimate(estimator, init_state));
+
+    if ( !is_solvable(base_node) ) {
+        delete base_node;
+        throw std::runtime_error("given starting permutation is not solvable!\n");
+    }
+
+    typedef PackedState<Node::grid_size> Packed;
+    std::unordered_map<Packed::type, short> best_distance; // the smallest g a node was built with per state
+    best_distance[Packed::pack(init_state)] = 0;
+
+    //// begin EPEA*
+    open.push(base_node);
+    std::vector<Node*> feasible_solutions;
+    short current_min_val = INT16_MAX;
+
+    std::ofstream result_dump;
+    if (verbose) result_dump.open("../algorithm_logs.txt");
+
+    while (!open.empty()) {
+
+        nodes_expanded++;
+        auto* current_node = open.top();
+        open.pop();
+        visited.insert(current_node); // every node is either in open or in visited
+
+        if (current_min_val < current_node->f_cost - 1) {
+            continue;
+        }
+        bool first_expansion = current_node->f_cost == current_node->g_cost + current_node->h_cost;
+
+        if (verbose) {
+            result_dump << "\n";
+            result_dump << "current_node->h_cost " << current_node->h_cost << "\n";
+            result_dump << "current_node->g_cost " << current_node->g_cost << "\n";
+            result_dump << "current_node->f_cost " << current_node->f_cost << "\n";
+            result_dump << "\n";
+        }
+
+        if (first_expansion && endgame_table != nullptr) {
+            auto packed = EndgameTable::Packed::pack(current_node->game_state);
+            if (endgame_table->distance(packed) >= 0) {
+                //// the rest of the path is read off the table
+                Node* node = current_node;
+                MoveString rest = endgame_table->finish(packed);
+                for (size_t i = 0; i < rest.size(); i++) {
+                    node = create_child(node, MoveString::offset(rest[i], Node::grid_size), estimator);
+                    visited.insert(node);
+                }
+                feasible_solutions.push_back(node);
+                return feasible_solutions;
+            }
+        }
+
+        if (first_expansion && current_node->h_cost == 0) {
+            bool feasible = true;
+            for (int i = 0 ; i < Node::grid_size * Node::grid_size - 1; i++) {
+                if (current_node->game_state[i] != static_cast<char>(i+1)) {
+                    feasible = false;
+                    break;
+                }
+            }
+            if (feasible){
+                feasible_solutions.push_back(current_node);
+                current_min_val = std::min(current_min_val, current_node->g_cost);
+                if (verbose) std::cout<<"i found a solution candidate! distance:" << current_node->g_cost <<"\n";
+            }
+        }
+
+        int estimates[4];
+        child_estimates(estimator, current_node, estimates);
+        int towards_parent = current_node->get_direction_towards_parent();
+        int next_f = INT_MAX;
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            int direction = MoveString::offset(move, Node::grid_size);
+            if (estimates[move] < 0 || direction == towards_parent) {
+                continue;
+            }
+            int f = current_node->g_cost + 1 + estimates[move];
+            if (f > current_node->f_cost) {
+                next_f = std::min(next_f, f);
+                continue;
+            }
+            if (f < current_node->f_cost && !first_expansion) {
+                continue; // built the first time round
+            }
+
+            auto distance = static_cast<short>(current_node->g_cost + 1);
+            char game_state[Node::grid_size * Node::grid_size];
+            std::memcpy(game_state, current_node->game_state, Node::grid_size * Node::grid_size);
+            MoveString::apply(game_state, Node::grid_size, current_node->current, move);
+            auto known = best_distance.emplace(Packed::pack(game_state), distance);
+            if (!known.second) {
+                if (known.first->second <= distance) continue;
+                known.first->second = distance;
+            }
+
+            open.push(create_child(current_node, direction, static_cast<short>(estimates[move])));
+            nodes_generated++;
+        }
+
+        if (next_f != INT_MAX) {
+            //// back into the queue for the children with the next f
+            visited.erase(current_node);
+            current_node->f_cost = static_cast<short>(next_f);
+            open.push(current_node);
+        }
+    }
+    return feasible_solutions;
+}
+
+// Frontier A* (Korf's frontier search). Only the open list is kept: an
+// expanded node is dropped right away, and every node in the list carries the
+// used-operator bits of the moves that lead back to an already expanded
+// neighbour. Expanding a node sets the bit towards it in each neighbour it
+// builds or finds in the list, so a dropped node is never built again and no
+// closed list is needed. Without parent pointers every node carries its
+// ancestor on the relay layer (g == relay_depth) instead; once the goal comes
+// off the queue, the path is put together by divide and conquer - the pieces
+// start -> relay and relay -> goal are searched the same way, towards a given
+// board with the Manhattan distance to it, until they are single moves.
+// Returns g of the goal, its relay (0 when it lies above the relay layer).
+template<class Estimate>
+int Solver::frontier_search(uint64_t start, uint64_t goal, int relay_depth, const Estimate& estimate, uint64_t& relay) {
+    typedef PackedState<Node::grid_size> Packed;
+    struct Entry {
+        short f_cost, h_cost, g_cost;
+        uint64_t state;
+        bool operator<(const Entry& other) const { // the queue's top: smallest f, then smallest h
+            return f_cost != other.f_cost ? f_cost > other.f_cost : h_cost > other.h_cost;
+        }
+    };
+    std::unordered_map<uint64_t, FrontierNode> frontier_nodes;
+    std::priority_queue<Entry> queue; // entries left behind by a shorter path are skipped when they come up
+
+    char game_state[Node::grid_size * Node::grid_size];
+    Packed::unpack(start, game_state);
+    auto h = static_cast<short>(estimate(game_state));
+    frontier_nodes[start] = FrontierNode{0, h, 0, relay_depth == 0 ? start : 0};
+    queue.push(Entry{h, h, 0, start});
+
+    while (!queue.empty()) {
+        Entry top = queue.top();
+        queue.pop();
+        auto found = frontier_nodes.find(top.state);
+        if (found == frontier_nodes.end() || found->second.g_cost != top.g_cost) continue;
+        FrontierNode node = found->second;
+        if (top.state == goal) {
+            relay = node.relay;
+            return node.g_cost;
+        }
+        frontier_nodes.erase(found);
+        nodes_expanded++;
+
+        Packed::unpack(top.state, game_state);
+        int blank = find_current_blank_space_index(game_state);
+        auto distance = static_cast<short>(node.g_cost + 1);
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if ((node.used_operators >> move & 1) || !blank_can_move<Node::grid_size>(blank, move)) continue;
+            int destination = blank + MoveString::offset(move, Node::grid_size);
+            uint64_t child = Packed::move_blank(top.state, blank, destination);
+            uint64_t child_relay = distance == relay_depth ? child : node.relay;
+            auto back = static_cast<uint8_t>(1 << MoveString::inverse(move));
+            nodes_generated++;
+
+            auto known = frontier_nodes.find(child);
+            if (known != frontier_nodes.end()) {
+                known->second.used_operators |= back;
+                if (known->second.g_cost <= distance) continue;
+                known->second.g_cost = distance;
+                known->second.relay = child_relay;
+                queue.push(Entry{static_cast<short>(distance + known->second.h_cost), known->second.h_cost, distance, child});
+                continue;
+            }
+            MoveString::apply(game_state, Node::grid_size, blank, move);
+            auto child_h = static_cast<short>(estimate(game_state));
+            MoveString::apply(game_state, Node::grid_size, destination, MoveString::inverse(move));
+            frontier_nodes.emplace(child, FrontierNode{distance, child_h, back, child_relay});
+            queue.push(Entry{static_cast<short>(distance + child_h), child_h, distance, child});
+        }
+        peak_frontier = std::max(peak_frontier, frontier_nodes.size());
+    }
+    throw std::runtime_error("search space exhausted without reaching the goal");
+}
+
+// the move between two neighbouring boards
+MoveString Solver::single_move(uint64_t from, uint64_t to) {
+    typedef PackedState<Node::grid_size> Packed;
+    MoveString moves;
+    int blank = Packed::find_blank(from);
+    for (int move = MoveString::up; move <= MoveString::right; move++) {
+        if (!blank_can_move<Node::grid_size>(blank, move)) continue;
+        if (Packed::move_blank(from, blank, blank + MoveString::offset(move, Node::grid_size)) == to) {
+            moves.push_back(move);
+            return moves;
+        }
+    }
+    throw std::logic_error("relay boards are not neighbours");
+}
+
+Solver::TargetManhattan::TargetManhattan(uint64_t target) {
+    for (int cell = 0; cell < Node::grid_size * Node::grid_size; cell++) {
+        target_cell[PackedState<Node::grid_size>::tile_at(target, cell)] = cell;
+    }
+}
+
+int Solver::TargetManhattan::operator()(const char* game_state) const {
+    int sum = 0;
+    for (int cell = 0; cell < Node::grid_size * Node::grid_size; cell++) {
+        if (game_state[cell] == 0) continue;
+        int home = target_cell[static_cast<int>(game_state[cell])];
+        sum += std::abs(cell % Node::grid_size - home % Node::grid_size) + std::abs(cell / Node::grid_size - home / Node::grid_size);
+    }
+    return sum;
+}
+
+// the moves from start to goal: one frontier search for the distance and the
+// relay, then the two halves on their own
+template<class Estimate>
+MoveString Solver::divide(uint64_t start, uint64_t goal, int relay_depth, const Estimate& estimate) {
+    if (start == goal) return MoveString();
+    uint64_t relay = 0;
+    int distance = frontier_search(start, goal, relay_depth, estimate, relay);
+    if (distance > 1 && relay == 0) {
+        //// the goal lies above the relay layer, halve the real distance instead
+        relay_depth = distance / 2;
+        distance = frontier_search(start, goal, relay_depth, estimate, relay);
+    }
+    if (distance == 1) return single_move(start, goal);
+    MoveString moves = connect(start, relay, relay_depth);
+    moves.append(connect(relay, goal, distance - relay_depth));
+    return moves;
+}
+
+// a shortest path between two boards at most `length` moves apart, searched
+// with the Manhattan distance towards `to`
+MoveString Solver::connect(uint64_t from, uint64_t to, int length) {
+    if (from == to) return MoveString();
+    return divide(from, to, std::max(length / 2, 1), TargetManhattan(to));
+}
+
+template<class Heuristic>
+MoveString Solver::find_frontier_solution(const Heuristic& estimator) {
+    typedef PackedState<Node::grid_size> Packed;
+    //// an expanded node is never reopened, so the first g it comes off the queue with has to be
+    //// its shortest - only a consistent estimate promises that
+    if (!Heuristic::is_consistent) {
+        throw std::invalid_argument(std::string("frontier search needs a consistent heuristic, ") + Heuristic::name() + " is not");
+    }
+    std::unique_ptr<char[]> start_state(init_state); // no base node to own it in this mode
+    init_state = nullptr;
+    nodes_expanded = 0;
+    nodes_generated = 0;
+    peak_frontier = 0;
+    if (!Inversions::is_solvable(start_state.get(), Node::grid_size)) {
+        throw std::runtime_error("given starting permutation is not solvable!\n");
+    }
+
+    char goal_state[Node::grid_size * Node::grid_size];
+    for (int cell = 0; cell < Node::grid_size * Node::grid_size; cell++) {
+        goal_state[cell] = static_cast<char>((cell + 1) % (Node::grid_size * Node::grid_size));
+    }
+    auto by_estimate = [this, &estimator](char* game_state) { return estimate(estimator, game_state); };
+    //// the relay layer halfway down the estimate
+    int relay_depth = std::max(estimate(estimator, start_state.get()) / 2, 1);
+    return divide(Packed::pack(start_state.get()), Packed::pack(goal_state), relay_depth, by_estimate);
+}
+// Breadth-first heuristic search (Zhou and Hansen): breadth first from the
+// start, dropping every child with g + h above the bound. A layer is a flat
+// array of packed states sorted by state; the next one is sorted, stripped of
+// repeats and merged against the layer before the current one, which is then
+// freed. The current layer itself needs no check: a move takes the blank to a
+// cell of the other checkerboard colour, so no child lies in its parent's
+// layer. Nodes carry relays as in frontier search. Returns the goal's g, -1
+// when no path stays within the bound.
+template<class Estimate>
+int Solver::layered_search(uint64_t start, uint64_t goal, int bound, int relay_depth, const Estimate& estimate, uint64_t& relay) {
+    typedef PackedState<Node::grid_size> Packed;
+    std::vector<LayerNode> previous, current{LayerNode{start, relay_depth == 0 ? start : 0}}, next;
+    if (start == goal) {
+        relay = current.front().relay;
+        return 0;
+    }
+    char game_state[Node::grid_size * Node::grid_size];
+    for (int g = 0; g < bound && !current.empty(); g++) {
+        next.clear();
+        for (const auto& node : current) {
+            nodes_expanded++;
+            Packed::unpack(node.state, game_state);
+            int blank = find_current_blank_space_index(game_state);
+            for (int move = MoveString::up; move <= MoveString::right; move++) {
+                if (!blank_can_move<Node::grid_size>(blank, move)) continue;
+                int destination = MoveString::apply(game_state, Node::grid_size, blank, move);
+                int h = estimate(game_state);
+                MoveString::apply(game_state, Node::grid_size, destination, MoveString::inverse(move));
+                nodes_generated++;
+                if (g + 1 + h > bound) continue;
+
+                uint64_t child = Packed::move_blank(node.state, blank, destination);
+                uint64_t child_relay = g + 1 == relay_depth ? child : node.relay;
+                if (child == goal) {
+                    relay = child_relay;
+                    return g + 1;
+                }
+                next.push_back(LayerNode{child, child_relay});
+            }
+        }
+
+        std::sort(next.begin(), next.end(), [](const LayerNode& a, const LayerNode& b) { return a.state < b.state; });
+        next.erase(std::unique(next.begin(), next.end(), [](const LayerNode& a, const LayerNode& b) { return a.state == b.state; }),
+                   next.end());
+        //// a merge against the layer before: what it holds was reached two moves ago
+        size_t kept = 0, seen = 0;
+        for (const auto& node : next) {
+            while (seen < previous.size() && previous[seen].state < node.state) seen++;
+            if (seen < previous.size() && previous[seen].state == node.state) continue;
+            next[kept++] = node;
+        }
+        next.resize(kept);
+        peak_frontier = std::max(peak_frontier, previous.size() + current.size() + next.size());
+        previous.swap(current);
+        current.swap(next); // the oldest layer's buffer is reused for the next one
+    }
+    return -1;
+}
+
+// false when no path from start to goal stays within the bound
+template<class Estimate>
+bool Solver::layered_divide(uint64_t start, uint64_t goal, int bound, const Estimate& estimate, MoveString& moves) {
+    moves.clear();
+    if (start == goal) return true;
+    int relay_depth = std::max(bound / 2, 1);
+    uint64_t relay = 0;
+    int distance = layered_search(start, goal, bound, relay_depth, estimate, relay);
+    if (distance < 0) return false;
+    if (distance > 1 && relay == 0) {
+        //// same bound again, only the relay layer moves: a tighter one lets an inadmissible
+        //// estimate prune the very path just found
+        relay_depth = distance / 2;
+        distance = layered_search(start, goal, bound, relay_depth, estimate, relay);
+        if (distance < 0 || (distance > 1 && relay == 0)) return false;
+    }
+    if (distance == 1) {
+        moves = single_move(start, goal);
+        return true;
+    }
+    MoveString rest;
+    if (!layered_divide(start, relay, relay_depth, TargetManhattan(relay), moves)
+        || !layered_divide(relay, goal, distance - relay_depth, TargetManhattan(goal), rest)) {
+        throw std::logic_error("a piece between relays is longer than the path it came from");
+    }
+    moves.append(rest);
+    return true;
+}
+
+// Breadth-first iterative deepening: breadth-first heuristic search with the
+// bound given by set_upper_bound(), or - without one, or when an inadmissible
+// estimate prunes every path within it - from the start's estimate up in steps
+// of two, the parity every path to the goal shares. Only the last two layers
+// and the one being built are held.
+template<class Heuristic>
+MoveString Solver::find_breadth_first_solution(const Heuristic& estimator) {
+    typedef PackedState<Node::grid_size> Packed;
+    std::unique_ptr<char[]> start_state(init_state); // no base node to own it in this mode
+    init_state = nullptr;
+    nodes_expanded = 0;
+    nodes_generated = 0;
+    peak_frontier = 0;
+    if (!Inversions::is_solvable(start_state.get(), Node::grid_size)) {
+        throw std::runtime_error("given starting permutation is not solvable!\n");
+    }
+
+    char goal_state[Node::grid_size * Node::grid_size];
+    for (int cell = 0; cell < Node::grid_size * Node::grid_size; cell++) {
+        goal_state[cell] = static_cast<char>((cell + 1) % (Node::grid_size * Node::grid_size));
+    }
+    uint64_t start = Packed::pack(start_state.get()), goal = Packed::pack(goal_state);
+    auto by_estimate = [this, &estimator](char* game_state) { return estimate(estimator, game_state); };
+
+    int bound = upper_bound > 0 ? upper_bound : estimate(estimator, start_state.get());
+    int blank = find_current_blank_space_index(start_state.get());
+    int blank_distance = 2 * (Node::grid_size - 1) - blank % Node::grid_size - blank / Node::grid_size;
+    if (bound % 2 != blank_distance % 2) bound++; // every path to the goal has the parity of the blank's way home
+    MoveString moves;
+    while (!layered_divide(start, goal, bound, by_estimate, moves)) bound += 2;
+    return moves;
+}
+
+
+Solver::~Solver() {
+    release_search_memory();
+}
+
+bool Solver::is_valid_move(int origin, int destination){
+    return destination >= 0
+           && destination < Node::grid_size * Node::grid_size
+           && (abs((destination % Node::grid_size) - (origin % Node::grid_size)) == 1 || abs(destination - origin) != 1);
+}
+
+int Solver::find_current_blank_space_index(const char* game_state) {
+    int current = -1;
+    for (int i = 0; i < Node::grid_size * Node::grid_size; ++i ) {
+        if (game_state[i] == 0){
+            current = i;
+            break;
+        }
+    }
+    if (current == -1) {
+        throw std::invalid_argument("game_state is invalid, no blank space found!");
+    }
+
+    return current;
+}
+
+short Solver::legacy_heuristic_cost(const char* game_state) {
+    return static_cast<short>(LegacyWalkingDistance<Node::grid_size>::evaluate(game_state));
+}
+
+short Solver::heuristic_function_manhattan_with_linear_conflict(char* game_state) {
+    return static_cast<short>(LegacyLinearConflict<Node::grid_size>::evaluate(game_state));
+}
+
+short Solver::heuristic_function_manhattan(char* game_state) {
+    return static_cast<short>(LegacyManhattan<Node::grid_size>::evaluate(game_state));
+}
+
+short Solver::heuristic_function_walking_distance(char* game_state) {
+    return static_cast<short>(LegacyWalkingDistance<Node::grid_size>::evaluate(game_state)); // finds the blank itself
+}
+
+
+
+short Solver::heuristic_function_inversion_distance(const char* game_state) {
+    return static_cast<short>(InversionDistance<Node::grid_size>::evaluate(game_state));
+}
+
+
+int Solver::do_move(char* game_state, int direction) {
+    int current = find_current_blank_space_index(game_state);
+    return do_move(game_state, direction, current);
+}
+
+// returns current index of 0 in the puzzle
+int Solver::do_move(char* game_state, int direction, int current){
+
+    int destination = current + direction;
+
+    if (!is_valid_move(current, destination)){
+        throw std::invalid_argument("invalid move direction");
+    }
+
+    game_state[current] = game_state[destination];
+    game_state[destination] = 0;
+    current = destination;
+
+    return current;
+}
+
+
+bool Solver::Compare::operator()(Solver::Node *a, Solver::Node *b) {
+    if (a->f_cost > b->f_cost) {
+        return true;
+    } else if (a->f_cost == b->f_cost && a->h_cost > b->h_cost) {
+        return true;
+    }
+    return false;
+}
+
+
+
+size_t Solver::game_state_hasher::operator()(const Node *node) const {
+    std::hash<char> hasher;
+    size_t seed = 0;
+    for (int i = 0 ; i < Node::grid_size * Node::grid_size; i++) {
+        seed ^= hasher(node->game_state[i]) + 0x9e3779b9 + (seed<<6) + (seed>>2);
+    }
+    return seed;
 }
\ No newline at end of file
@@ -1,237 +1,336 @@
-//
-// Created by adame on 4/4/2023.
-//
-
-#ifndef SOLVER_H
-#define SOLVER_H
-#include <iostream>
-#include <cstddef>
-#include <vector>
-#include <queue>
-#include <unordered_set>
-#include <stdexcept>
-#include <cstring>
-#include <random>
-#include <algorithm>
-#include <fstream>
-#include <chrono>
-
-
-
-class Solver {
-public:
-    struct Node {
-        static const int grid_size = 4;
-        enum direction {
-            up = -grid_size,
-            down = grid_size,
-            left = -1,
-            right = 1
-        };
-//    std::vector<direction> all_directions;
-        static const std::vector<direction> all_directions;
-
-
-        Solver::Node* parent = nullptr;
-        char* game_state = nullptr;
-        int current = -1;
-        short f_cost = -1;
-        short h_cost = -1;
-        short g_cost = -1;
-
-        struct Point{
-            int x, y;
-        };
-
-        static Point to_coordinate(int index){
-            if (index < 0 || index >= grid_size*grid_size)
-                throw std::runtime_error("Invalid index. Cannot convert to point.");
-
-            Point result{ index % grid_size, index / grid_size };
-            return result;
-        }
-
-        int calculate_f_cost() {
-            return get_distance_cost() + get_heuristic_cost();
-        }
-
-        int calculate_heuristic_cost() const {
-//            return Solver::heuristic_function_manhattan(game_state);
-        return Solver::heuristic_function_walking_distance(game_state, current); //put -1 in place of current to calculate it automatically
-//        return Solver::heuristic_function_manhattan_with_linear_conflict(game_state);
-//        return Solver::heuristic_function_inversion_distance(game_state);
-        }
-
-        int calculate_distance_cost() const {
-            if (parent == nullptr) {
-                return 0;
-            }
-
-            return parent->g_cost + 1;
-        }
-
-        short get_heuristic_cost(){
-            if (h_cost == -1) h_cost = calculate_heuristic_cost();
-            return h_cost;
-        }
-
-        short get_distance_cost() {
-            if (g_cost == -1) g_cost = calculate_distance_cost();
-            return g_cost;
-        }
-
-        short get_f_cost() {
-            if (f_cost == -1) f_cost = calculate_f_cost();
-            return f_cost;
-        }
-
-        int get_direction_towards_parent() const{
-            if (parent == nullptr) {
-                return grid_size + 1; //any unfeasible dir
-            }
-            return parent->current - current;
-        }
-
-        ~Node() {
-            delete[] game_state;
-        }
-
-        explicit Node(int shuffle_depth) {
-            game_state = generate_target();
-            shuffle(game_state, shuffle_depth);
-            current = Solver::find_current_blank_space_index(game_state);
-            parent = nullptr;
-            get_f_cost(); // calculates h,g,f costs and sets them
-        }
-
-        explicit Node(char* _game_state) {
-            game_state = _game_state;
-            current = Solver::find_current_blank_space_index(game_state);
-            parent = nullptr;
-            get_f_cost(); // calculates h,g,f costs and sets them
-        }
-
-        Node(char* _game_state, Node* _parent){
-            game_state = _game_state;
-            current = Solver::find_current_blank_space_index(game_state);
-            parent = _parent;
-            get_f_cost(); // calculates h,g,f costs and sets them
-        }
-
-        Node(char* _game_state, Node* _parent, int _current){
-            game_state = _game_state;
-            current = _current;
-            parent = _parent;
-            get_f_cost(); // calculates h,g,f costs and sets them
-        }
-
-        static Node* create_new_node(Node* _parent, int direction){
-            if (_parent->game_state == nullptr || _parent->current == -1 || _parent->g_cost == -1) {
-                throw std::runtime_error("You shouldn't initialize new Node by mal-constructed parent node!");
-            }
-            if (!Solver::is_valid_move(_parent->current, _parent->current + direction)) {
-                throw std::invalid_argument("invalid move!"); //asserted noexcept calling do_move(..)
-            }
-
-            char* _game_state = new char[grid_size*grid_size];
-            std::memcpy(_game_state, _parent->game_state, grid_size * grid_size);
-            int _current = Solver::do_move(_game_state, direction, _parent->current); //asserted noexcept
-
-            return new Node(_game_state, _parent, _current);
-        }
-
-        static char* generate_target() {
-            char *target = static_cast<char *>(malloc(sizeof(char) * Node::grid_size * Node::grid_size));
-            for (char i = 0; i < Node::grid_size * Node::grid_size; i++)
-                target[i] = static_cast<char> (i + 1);
-
-            target[ (Node::grid_size * Node::grid_size) - 1 ] = 0;
-
-            return target;
-        }
-
-        static char* generate_random_target() {
-            char *target = generate_target();
-            std::random_device rd;
-            std::mt19937 mt(rd());
-
-            std::shuffle(target, target + Node::grid_size * Node::grid_size, mt);
-
-            return target;
-        }
-
-
-        void shuffle(char*& perm, int num_of_permutations){
-
-            int current = 0;
-            for (int i = 0; i < Node::grid_size * Node::grid_size; ++i ){
-                if (perm[i] == 0){
-                    current = i;
-                    break;
-                }
-            }
-
-            std::random_device rd;
-            std::mt19937 mt(rd());
-            std::uniform_int_distribution<int> uni(0, Node::grid_size - 1);
-
-            int previous_direction = Node::grid_size + 1; //neither up,down,left nor right
-            for (int i = 0; i < num_of_permutations; ++i){
-                int random_direction;
-                int destination;
-
-                do {
-                    random_direction = all_directions[ uni(mt) ];
-                    destination = current + random_direction;
-                } while(!is_valid_move(current, destination) && random_direction != -1 * previous_direction);
-
-
-                previous_direction = random_direction;
-
-                perm[current] = perm[destination];
-                perm[destination] = 0;
-                current = destination;
-
-//        std::cout<<"(within shuffle)"<<std::endl;
-//        print_game_state(perm);
-            }
-        }
-
-
-
-    };
-
-    class Compare {
-    public:
-        bool operator()(Solver::Node* a, Solver::Node* b); //how to compare two nodes
-    };
-    class game_state_hasher {
-    public:
-        size_t operator()(const Node* node) const; // how to distinguish nodes from those in the visited-nodes set
-    };
-    std::vector<Node*> solve();
-    explicit Solver(char*) noexcept;
-    ~Solver() noexcept;
-    bool is_solvable(Node*);
-    static short heuristic_function_inversion_distance(const char* game_state);
-
-    static int do_move(char* game_state, int direction);
-    static int do_move(char* game_state, int direction, int current);
-    static short heuristic_function_walking_distance(char* game_state, int current);
-    static short heuristic_function_manhattan(char* game_state);
-    static short heuristic_function_manhattan_with_linear_conflict(char* game_state);
-
-    static bool is_valid_move(int origin, int destination);
-
-    static int find_current_blank_space_index(const char* game_state);
-private:
-
-    char* init_state;
-    std::vector<Node*> solution;
-    std::priority_queue<Node*, std::vector<Node*>, Compare> open;
-    std::unordered_set<Node*, game_state_hasher> visited;
-    std::vector<Node*> find_feasible_solution();
-};
-
-
-#endif //SOLVER_H
+//
+// Created by adame on 4/4/2023.
+//
+
+#ifndef SOLVER_H
+#define SOLVER_H
+#include <iostream>
+#include <cstddef>
+#include <vector>
+#include <queue>
+#include <unordered_set>
+#include <stdexcept>
+#include <cstring>
+#include <random>
+#include <algorithm>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include "Solution.h"
+#include "InstanceGenerator.h"
+
+
+class EndgameTable;
+
+class Solver {
+public:
+    struct Node {
+        static const int grid_size = 4;
+        enum direction {
+            up = -grid_size,
+            down = grid_size,
+            left = -1,
+            right = 1
+        };
+//    std::vector<direction> all_directions;
+        static const std::vector<direction> all_directions;
+
+
+        Solver::Node* parent = nullptr;
+        char* game_state = nullptr;
+        int current = -1;
+        short f_cost = -1;
+        short h_cost = -1;
+        short g_cost = -1;
+
+        struct Point{
+            int x, y;
+        };
+
+        static Point to_coordinate(int index){
+            if (index < 0 || index >= grid_size*grid_size)
+                throw std::runtime_error("Invalid index. Cannot convert to point.");
+
+            Point result{ index % grid_size, index / grid_size };
+            return result;
+        }
+
+        int calculate_f_cost() {
+            return get_distance_cost() + get_heuristic_cost();
+        }
+
+        int calculate_heuristic_cost() const {
+            return Solver::legacy_heuristic_cost(game_state);
+        }
+
+        int calculate_distance_cost() const {
+            if (parent == nullptr) {
+                return 0;
+            }
+
+            return parent->g_cost + 1;
+        }
+
+        short get_heuristic_cost(){
+            if (h_cost == -1) h_cost = calculate_heuristic_cost();
+            return h_cost;
+        }
+
+        short get_distance_cost() {
+            if (g_cost == -1) g_cost = calculate_distance_cost();
+            return g_cost;
+        }
+
+        short get_f_cost() {
+            if (f_cost == -1) f_cost = calculate_f_cost();
+            return f_cost;
+        }
+
+        int get_direction_towards_parent() const{
+            if (parent == nullptr) {
+                return grid_size + 1; //any unfeasible dir
+            }
+            return parent->current - current;
+        }
+
+        ~Node() {
+            delete[] game_state;
+        }
+
+        explicit Node(int shuffle_depth) {
+            game_state = generate_target();
+            shuffle(game_state, shuffle_depth);
+            current = Solver::find_current_blank_space_index(game_state);
+            parent = nullptr;
+            get_f_cost(); // calculates h,g,f costs and sets them
+        }
+
+        explicit Node(char* _game_state) {
+            game_state = _game_state;
+            current = Solver::find_current_blank_space_index(game_state);
+            parent = nullptr;
+            get_f_cost(); // calculates h,g,f costs and sets them
+        }
+
+        Node(char* _game_state, Node* _parent){
+            game_state = _game_state;
+            current = Solver::find_current_blank_space_index(game_state);
+            parent = _parent;
+            get_f_cost(); // calculates h,g,f costs and sets them
+        }
+
+        Node(char* _game_state, Node* _parent, int _current){
+            game_state = _game_state;
+            current = _current;
+            parent = _parent;
+            get_f_cost(); // calculates h,g,f costs and sets them
+        }
+
+        // h already known - the search estimates with the heuristic it was compiled for
+        Node(char* _game_state, Node* _parent, int _current, short _h_cost){
+            game_state = _game_state;
+            current = _current;
+            parent = _parent;
+            h_cost = _h_cost;
+            get_f_cost();
+        }
+
+        static Node* create_new_node(Node* _parent, int direction){
+            if (_parent->game_state == nullptr || _parent->current == -1 || _parent->g_cost == -1) {
+                throw std::runtime_error("You shouldn't initialize new Node by mal-constructed parent node!");
+            }
+            if (!Solver::is_valid_move(_parent->current, _parent->current + direction)) {
+                throw std::invalid_argument("invalid move!"); //asserted noexcept calling do_move(..)
+            }
+
+            char* _game_state = new char[grid_size*grid_size];
+            std::memcpy(_game_state, _parent->game_state, grid_size * grid_size);
+            int _current = Solver::do_move(_game_state, direction, _parent->current); //asserted noexcept
+
+            return new Node(_game_state, _parent, _current);
+        }
+
+        static char* generate_target() {
+            char *target = new char[Node::grid_size * Node::grid_size]; // delete[] like every board the nodes own
+            for (char i = 0; i < Node::grid_size * Node::grid_size; i++)
+                target[i] = static_cast<char> (i + 1);
+
+            target[ (Node::grid_size * Node::grid_size) - 1 ] = 0;
+
+            return target;
+        }
+
+        // uniform over the solvable boards
+        static char* generate_random_target() {
+            char *target = generate_target();
+            InstanceGenerator generator(grid_size, std::random_device{}());
+            generator.random(target);
+            return target;
+        }
+
+
+        void shuffle(char*& perm, int num_of_permutations){
+
+            int current = 0;
+            for (int i = 0; i < Node::grid_size * Node::grid_size; ++i ){
+                if (perm[i] == 0){
+                    current = i;
+                    break;
+                }
+            }
+
+            //// seeded once per thread, not on every call
+            static thread_local Xoshiro256 random_source{std::random_device{}()};
+
+            int previous_direction = Node::grid_size + 1; //neither up,down,left nor right
+            for (int i = 0; i < num_of_permutations; ++i){
+                int random_direction;
+                int destination;
+
+                do {
+                    random_direction = all_directions[ random_source.below(static_cast<uint32_t>(all_directions.size())) ];
+                    destination = current + random_direction;
+                } while(!is_valid_move(current, destination) || random_direction == -1 * previous_direction);
+
+
+                previous_direction = random_direction;
+
+                perm[current] = perm[destination];
+                perm[destination] = 0;
+                current = destination;
+
+//        std::cout<<"(within shuffle)"<<std::endl;
+//        print_game_state(perm);
+            }
+        }
+
+
+
+    };
+
+    class Compare {
+    public:
+        bool operator()(Solver::Node* a, Solver::Node* b); //how to compare two nodes
+    };
+    class game_state_hasher {
+    public:
+        size_t operator()(const Node* node) const; // how to distinguish nodes from those in the visited-nodes set
+    };
+    // runs A* once (later calls return the cached result) and frees every node
+    // of the search before returning - the path survives only as a move string
+    Solution solve();
+    void set_verbose(bool _verbose) { verbose = _verbose; } // off: no log file, no progress on stdout
+    // on: enhanced partial expansion (EPEA*) - an expansion only builds the
+    // children whose f equals the node's stored f and puts the node back with
+    // the next f its remaining children have
+    void set_partial_expansion(bool _partial_expansion) { partial_expansion = _partial_expansion; }
+    // on: frontier search - keeps only the open list, the path comes back by
+    // divide and conquer through a relay layer (see find_frontier_solution);
+    // solve() throws std::invalid_argument for a heuristic that is not consistent
+    void set_frontier_search(bool _frontier) { frontier = _frontier; }
+    // on: breadth-first heuristic search - layer by layer within a bound, only
+    // the last layers kept (see find_breadth_first_solution); the bound is
+    // the upper bound when one is set (e.g. the length of a quick suboptimal
+    // solve), else it deepens from the start's estimate. Only an admissible
+    // heuristic makes the path the shortest; an inadmissible one still gives a
+    // path within the bound, just not necessarily the shortest
+    void set_breadth_first(bool _breadth_first) { breadth_first = _breadth_first; }
+    void set_upper_bound(int _upper_bound) { upper_bound = _upper_bound; }
+    // with a table set, states inside its radius get their exact distance as heuristic
+    // and A* stops as soon as it pops one of them (nullptr, the default, turns it off)
+    void set_endgame_table(const EndgameTable* _endgame_table) { endgame_table = _endgame_table; }
+    // a width above 0: beam search instead of A* - the best `_beam_width` boards
+    // of every depth go on, fixed time and memory but no optimality (see
+    // BeamSearch); each restart doubles the width and keeps a shorter path
+    void set_beam_search(size_t _beam_width, int _restarts = 0) { beam_width = _beam_width; beam_restarts = _restarts; }
+    size_t get_peak_frontier() const { return peak_frontier; } // the most nodes frontier or breadth-first search held at once
+    unsigned long long get_nodes_expanded() const { return nodes_expanded; }
+    unsigned long long get_nodes_generated() const { return nodes_generated; }
+    // the heuristic is a HeuristicRegistry spec, resolved when solve() runs
+    explicit Solver(char*, std::string heuristic = default_heuristic) noexcept;
+    static constexpr const char* default_heuristic = "legacy_walking_distance";
+    ~Solver() noexcept;
+    Solver(const Solver&) = delete;
+    Solver& operator=(const Solver&) = delete;
+    bool is_solvable(Node*);
+    static short heuristic_function_inversion_distance(const char* game_state);
+
+    static int do_move(char* game_state, int direction);
+    static int do_move(char* game_state, int direction, int current);
+    static short heuristic_function_walking_distance(char* game_state);
+    static short heuristic_function_manhattan(char* game_state);
+    static short heuristic_function_manhattan_with_linear_conflict(char* game_state);
+    // the legacy walking distance, whatever heuristic a Solver was built with - only the nodes
+    // built without an estimate use it, the searches pass their own
+    static short legacy_heuristic_cost(const char* game_state);
+
+    static bool is_valid_move(int origin, int destination);
+
+    static int find_current_blank_space_index(const char* game_state);
+private:
+    char* init_state;
+    std::string heuristic;
+    bool verbose = true;
+    bool partial_expansion = false;
+    bool frontier = false;
+    bool breadth_first = false;
+    int upper_bound = 0;
+    const EndgameTable* endgame_table = nullptr;
+    size_t beam_width = 0;
+    int beam_restarts = 0;
+    size_t peak_frontier = 0;
+    unsigned long long nodes_expanded = 0;
+    unsigned long long nodes_generated = 0;
+    bool solved = false;
+    Solution solution;
+    std::priority_queue<Node*, std::vector<Node*>, Compare> open;
+    std::unordered_set<Node*, game_state_hasher> visited;
+    template<class Heuristic>
+    std::vector<Node*> find_feasible_solution(const Heuristic& estimator);
+    template<class Heuristic>
+    std::vector<Node*> find_partial_expansion_solution(const Heuristic& estimator);
+    //// frontier search
+    struct FrontierNode {
+        short g_cost;
+        short h_cost;
+        uint8_t used_operators; // bit per move code: the neighbour that way is already expanded
+        uint64_t relay; // packed ancestor on the relay layer, 0 above it
+    };
+    template<class Heuristic>
+    MoveString find_frontier_solution(const Heuristic& estimator);
+    template<class Estimate>
+    int frontier_search(uint64_t start, uint64_t goal, int relay_depth, const Estimate& estimate, uint64_t& relay);
+    template<class Estimate>
+    MoveString divide(uint64_t start, uint64_t goal, int relay_depth, const Estimate& estimate);
+    MoveString connect(uint64_t from, uint64_t to, int length);
+    static MoveString single_move(uint64_t from, uint64_t to);
+    // the Manhattan distance towards any board, for the pieces between relays
+    struct TargetManhattan {
+        int target_cell[Node::grid_size * Node::grid_size];
+        explicit TargetManhattan(uint64_t target);
+        int operator()(const char* game_state) const;
+    };
+
+    //// breadth-first heuristic search
+    struct LayerNode {
+        uint64_t state;
+        uint64_t relay;
+    };
+    template<class Heuristic>
+    MoveString find_breadth_first_solution(const Heuristic& estimator);
+    template<class Estimate>
+    int layered_search(uint64_t start, uint64_t goal, int bound, int relay_depth, const Estimate& estimate, uint64_t& relay);
+    template<class Estimate>
+    bool layered_divide(uint64_t start, uint64_t goal, int bound, const Estimate& estimate, MoveString& moves);
+    template<class Heuristic>
+    void child_estimates(const Heuristic& estimator, const Node* node, int estimates[4]) const; // by move code, -1 off the board
+    template<class Heuristic>
+    short estimate(const Heuristic& estimator, char* game_state) const;
+    template<class Heuristic>
+    Node* create_child(Node* parent, int direction, const Heuristic& estimator) const; // nullptr off the board
+    static Node* create_child(Node* parent, int direction, short h_cost);
+    void release_search_memory();
+};
+
+
+#endif //SOLVER_H
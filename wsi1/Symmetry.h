@@ -0,0 +1,55 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef SYMMETRY_H
+#define SYMMETRY_H
+#include "MoveString.h"
+
+
+// Reflection of the game across the main diagonal. The goal keeps the blank
+// in the bottom right corner, which lies on the diagonal, so the reflected
+// goal is the goal again once every tile is renamed after the cell its
+// reflected goal cell belongs to. Distances are preserved, and a path for the
+// mirrored board is the original path with up <-> left and down <-> right.
+class Symmetry {
+public:
+    static int transpose(int index, int width) {
+        return (index % width) * width + index / width;
+    }
+
+    // tile t belongs at cell t - 1, in the mirror it belongs at transpose(t - 1)
+    static char relabel(char tile, int width) {
+        return tile == 0 ? 0 : static_cast<char>(transpose(tile - 1, width) + 1);
+    }
+
+    static void mirror(const char* game_state, char* mirrored, int width) {
+        for (int i = 0; i < width * width; i++) {
+            mirrored[transpose(i, width)] = relabel(game_state[i], width);
+        }
+    }
+
+    // the inverse permutation, with the blank standing in for tile width * width:
+    // the tile at cell c of the dual is the cell holding tile c + 1 in the original.
+    // Reaching the goal takes as many moves from the dual as from the original.
+    static void dual(const char* game_state, char* dualled, int width) {
+        int n = width * width;
+        for (int i = 0; i < n; i++) {
+            int tile = game_state[i] == 0 ? n : game_state[i];
+            dualled[tile - 1] = static_cast<char>(i + 1 == n ? 0 : i + 1);
+        }
+    }
+
+    static int mirror_move(int move) {
+        return move ^ 2; // up(0) <-> left(2), down(1) <-> right(3)
+    }
+
+    static MoveString mirror_moves(const MoveString& moves) {
+        MoveString mirrored;
+        for (size_t i = 0; i < moves.size(); i++) mirrored.push_back(mirror_move(moves[i]));
+        return mirrored;
+    }
+};
+
+
+#endif //SYMMETRY_H
@@ -0,0 +1,101 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "TranspositionTable.h"
+#include <algorithm>
+#include <stdexcept>
+
+
+static uint64_t encode(int lower_bound, int depth, uint8_t generation, uint32_t context) {
+    return static_cast<uint64_t>(std::min(lower_bound, 255))
+           | static_cast<uint64_t>(std::max(std::min(depth, 255), 0)) << 8
+           | static_cast<uint64_t>(generation) << 16
+           | static_cast<uint64_t>(context) << 32;
+}
+
+static int lower_bound_of(uint64_t data) { return static_cast<int>(data & 0xFF); }
+static int depth_of(uint64_t data) { return static_cast<int>((data >> 8) & 0xFF); }
+static uint8_t generation_of(uint64_t data) { return static_cast<uint8_t>((data >> 16) & 0xFF); }
+static uint32_t context_of(uint64_t data) { return static_cast<uint32_t>(data >> 32); }
+
+
+TranspositionTable::TranspositionTable(size_t megabytes, policy _replacement) : replacement(_replacement) {
+    size_t count = std::max<size_t>(megabytes * 1024 * 1024 / sizeof(Bucket), 1);
+    size_t buckets_count = 1;
+    while (buckets_count * 2 <= count) buckets_count *= 2;
+    buckets.reset(new Bucket[buckets_count]);
+    mask = buckets_count - 1;
+    clear();
+}
+
+void TranspositionTable::new_generation() {
+    generation = static_cast<uint8_t>(generation == 255 ? 1 : generation + 1); // 0 stays for empty slots
+}
+
+void TranspositionTable::clear() {
+    for (size_t i = 0; i <= mask; i++) {
+        for (auto& entry : buckets[i].entries) {
+            entry.check.store(0, std::memory_order_relaxed);
+            entry.data.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+TranspositionTable::policy TranspositionTable::parse_policy(const std::string& name) {
+    if (name == "depth") return depth_preferred;
+    if (name == "always") return always_replace;
+    throw std::invalid_argument("unknown replacement policy " + name + " (depth or always)");
+}
+
+size_t TranspositionTable::bucket_of(uint64_t state, uint32_t context) const {
+    uint64_t hash = (state ^ (static_cast<uint64_t>(context) * 0xC2B2AE3D27D4EB4FULL)) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(hash >> 20) & mask;
+}
+
+int TranspositionTable::lookup(uint64_t state, uint32_t context) const {
+    const Bucket& bucket = buckets[bucket_of(state, context)];
+    for (const auto& entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ data) == state && context_of(data) == context) {
+            return lower_bound_of(data);
+        }
+    }
+    return 0;
+}
+
+void TranspositionTable::store(uint64_t state, uint32_t context, int lower_bound, int depth) {
+    Bucket& bucket = buckets[bucket_of(state, context)];
+    Entry* victim = nullptr;
+    for (auto& entry : bucket.entries) {
+        uint64_t data = entry.data.load(std::memory_order_relaxed);
+        if ((entry.check.load(std::memory_order_relaxed) ^ data) == state && context_of(data) == context) {
+            //// both bounds hold, keep the better one
+            lower_bound = std::max(lower_bound, lower_bound_of(data));
+            depth = std::max(depth, depth_of(data));
+            victim = &entry;
+            break;
+        }
+    }
+
+    if (victim == nullptr && replacement == always_replace) {
+        victim = &bucket.entries[(state * 0x9E3779B97F4A7C15ULL >> 62) & (bucket_size - 1)];
+    }
+    if (victim == nullptr) {
+        int victim_rank = 0;
+        for (auto& entry : bucket.entries) {
+            uint64_t data = entry.data.load(std::memory_order_relaxed);
+            // empty slots first, then older generations, then the shallowest
+            int rank = data == 0 ? 0 : generation_of(data) != generation ? 1 + depth_of(data) : 512 + depth_of(data);
+            if (victim == nullptr || rank < victim_rank) {
+                victim = &entry;
+                victim_rank = rank;
+            }
+        }
+        if (victim_rank >= 512 && victim_rank - 512 > depth) return; // every entry here cost more to find
+    }
+
+    uint64_t data = encode(lower_bound, depth, generation, context);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(state ^ data, std::memory_order_relaxed);
+}
@@ -0,0 +1,83 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef TRANSPOSITIONTABLE_H
+#define TRANSPOSITIONTABLE_H
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+
+// Fixed-size memory for the depth-first engines (IdaStar, ParallelIdaStar):
+// what a finished search below a state proved about its distance to the goal.
+// Once a subtree comes back without the goal, every path out of it is at least
+// `lower_bound` long, so a later visit - in this iteration through another
+// path, or in the next one - with g + lower_bound above the bound is cut at
+// once. The bound only holds for the moves the move-pruning machine allowed
+// below the state, so an entry is keyed by the packed board together with
+// that machine state.
+//
+// There is no best-g field: a revisit at g' >= g after the earlier visit came
+// back is already cut, as that visit stored a bound above the iteration's
+// bound - g. A best g would still catch a state while its first visit is on
+// the stack, which needs a cycle the move pruning did not remove, and would
+// have to be cleared every iteration, while the lower bound carries over.
+//
+// Buckets of four entries fill a cache line. An entry is two words, the key
+// xor-ed with its data and the data, written and read without locks: a torn
+// entry no longer decodes to its key and reads as a miss, so threads share a
+// table freely. When a bucket is full
+//   depth_preferred overwrites an entry of an older generation, else the one
+//                   with the smallest searched depth (the cheapest to redo)
+//                   unless the new one is shallower still,
+//   always_replace  overwrites the slot the key hashes to.
+// new_generation() starts a new search; the bounds of older ones still hold
+// (the goal does not change), they are just the first to go.
+class TranspositionTable {
+public:
+    enum policy { depth_preferred, always_replace };
+
+    explicit TranspositionTable(size_t megabytes, policy _replacement = depth_preferred);
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // 0 when the state is unknown
+    int lookup(uint64_t state, uint32_t context) const;
+    // depth: the bound minus g the subtree was searched with
+    void store(uint64_t state, uint32_t context, int lower_bound, int depth);
+    // asks for the bucket ahead of a lookup() or store()
+    void prefetch(uint64_t state, uint32_t context) const { __builtin_prefetch(&buckets[bucket_of(state, context)]); }
+
+    void new_generation();
+    void clear();
+
+    size_t size() const { return (mask + 1) * bucket_size; } // entries
+    size_t size_in_bytes() const { return (mask + 1) * sizeof(Bucket); }
+    policy get_policy() const { return replacement; }
+
+    static policy parse_policy(const std::string& name); // "depth" or "always", throws std::invalid_argument
+
+private:
+    static const int bucket_size = 4;
+
+    struct Entry {
+        std::atomic<uint64_t> check; // state ^ data
+        std::atomic<uint64_t> data;  // lower bound (8 bits), depth (8), generation (8), context (32)
+    };
+    struct alignas(64) Bucket {
+        Entry entries[bucket_size];
+    };
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t mask;
+    policy replacement;
+    uint8_t generation = 1;
+
+    size_t bucket_of(uint64_t state, uint32_t context) const;
+};
+
+
+#endif //TRANSPOSITIONTABLE_H
@@ -0,0 +1,16 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include "TwentyFourSolver.h"
+#include <algorithm>
+#include <stdexcept>
+
+
+TwentyFourSolver::TwentyFourSolver(const std::string& database_path, int _threads)
+        : threads(std::max(_threads, 1)), database(database_path), heuristic(database),
+          search(heuristic, threads, nullptr, MovePruning::standard()) {
+    if (database.get_width() != width) {
+        throw std::invalid_argument(database_path + " is not a 5x5 pattern database");
+    }
+}
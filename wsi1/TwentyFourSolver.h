@@ -0,0 +1,47 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#ifndef TWENTYFOURSOLVER_H
+#define TWENTYFOURSOLVER_H
+#include <string>
+#include <thread>
+#include "MovePruning.h"
+#include "ParallelIdaStar.h"
+#include "PatternDatabase.h"
+#include "PatternHeuristic.h"
+#include "Solution.h"
+
+
+// The 5x5 engine. A* cannot hold the 24-puzzle's search space in memory, so
+// this is IDA* (ParallelIdaStar, every iteration split between the threads at
+// the root) with move pruning of the blank's short cycles and an additive
+// pattern database taken over the board and its mirror
+// (ReflectedPatternHeuristic). The database is meant to be the 6-6-6-6 one,
+//   pdb_gen --width 5 --partition 1,2,3,6,7,8/4,5,9,10,14,15/11,12,16,17,21,22/13,18,19,20,23,24
+// four 6-tile blocks (127.5M one-byte entries each, ~510 MB mapped) none of
+// which is the mirror of another, so the reflected lookup sees different
+// blocks; any 5x5 database works.
+class TwentyFourSolver {
+public:
+    static constexpr int width = 5;
+    static constexpr int tiles = width * width;
+
+    // throws std::runtime_error for a database that does not load, std::invalid_argument for one of another width
+    explicit TwentyFourSolver(const std::string& database_path, int threads = static_cast<int>(std::thread::hardware_concurrency()));
+
+    // throws std::runtime_error for a permutation that cannot reach the goal
+    Solution solve(const char* game_state) { return search.solve(game_state); }
+
+    unsigned long long get_nodes_expanded() const { return search.get_nodes_expanded(); }
+    int get_threads() const { return threads; }
+
+private:
+    int threads;
+    PatternDatabase database;
+    ReflectedPatternHeuristic heuristic;
+    ParallelIdaStar<width, ReflectedPatternHeuristic> search;
+};
+
+
+#endif //TWENTYFOURSOLVER_H
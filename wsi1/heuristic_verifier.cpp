@@ -0,0 +1,254 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include <algorithm>
+#include <climits>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+#include "HeuristicRegistry.h"
+#include "IdaStar.h"
+#include "PackedState.h"
+
+
+//// heuristic_verifier [--heuristic SPEC]... [--radius R] [--samples N] [--deep N] [--walk LENGTH]
+////                    [--radius24 R] [--seed S]
+//// checks every heuristic against exact distances:
+////   3x3 - all 181440 solvable states (breadth-first search from the goal)
+////   4x4 - the states within R moves of the goal (or N of them at random), plus
+////         N deep random-walk states solved exactly by IDA* with walking distance and linear conflict
+////   5x5 - the states within --radius24 moves of the goal, when given (walking_distance has
+////         no table that fits in memory there, name the heuristics with --heuristic)
+//// h <= h* on every state, h(parent) <= 1 + h(child) on every edge inside the set, and update()
+//// after a move against a fresh evaluate(). Exits with 1 when a heuristic declared admissible
+//// (or consistent) is caught overestimating (or jumping).
+
+struct Report {
+    std::string board;
+    std::string name;
+    bool declared_admissible = false, declared_consistent = false;
+    unsigned long long states = 0, overestimates = 0, edges = 0, inconsistent_edges = 0, update_mismatches = 0, exact = 0;
+    int worst_excess = 0;
+    std::string worst_state;
+    double ratio_sum = 0;
+    unsigned long long ratio_count = 0;
+    std::string skipped;
+};
+
+template<int Width>
+struct ExactSet {
+    typedef PackedState<Width> Packed;
+    std::unordered_map<typename Packed::type, uint8_t, typename Packed::hash> distance;
+    std::vector<typename Packed::type> states; // the ones the checks run over
+    std::vector<std::pair<typename Packed::type, int>> deep; // farther states with their solved distance
+};
+
+static std::string show(const char* game_state, int cells) {
+    std::stringstream out;
+    for (int i = 0; i < cells; i++) out << (i ? " " : "") << static_cast<int>(game_state[i]);
+    return out.str();
+}
+
+template<int Width>
+static bool leaves_board(int blank, int move) {
+    int x = blank % Width, y = blank / Width;
+    return (move == MoveString::up && y == 0) || (move == MoveString::down && y == Width - 1)
+           || (move == MoveString::left && x == 0) || (move == MoveString::right && x == Width - 1);
+}
+
+template<int Width>
+static void breadth_first(ExactSet<Width>& set, int radius) {
+    typedef PackedState<Width> Packed;
+    char goal[Width * Width];
+    for (int i = 0; i < Width * Width; i++) goal[i] = static_cast<char>((i + 1) % (Width * Width));
+    std::vector<typename Packed::type> queue = {Packed::pack(goal)};
+    set.distance[queue[0]] = 0;
+    for (size_t head = 0; head < queue.size(); head++) {
+        typename Packed::type state = queue[head];
+        int d = set.distance[state];
+        if (d == radius) continue;
+        int blank = Packed::find_blank(state);
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if (leaves_board<Width>(blank, move)) continue;
+            typename Packed::type child = Packed::move_blank(state, blank, blank + MoveString::offset(move, Width));
+            if (set.distance.emplace(child, static_cast<uint8_t>(d + 1)).second) queue.push_back(child);
+        }
+    }
+    set.states = queue;
+}
+
+template<int Width, class Heuristic>
+static Report verify(const Heuristic& heuristic, const ExactSet<Width>& set) {
+    typedef PackedState<Width> Packed;
+    Report report;
+    report.name = Heuristic::name();
+    report.declared_admissible = Heuristic::is_admissible;
+    report.declared_consistent = Heuristic::is_consistent;
+    char board[Width * Width];
+
+    auto check_state = [&](int h, int exact) {
+        report.states++;
+        if (h > exact) {
+            report.overestimates++;
+            if (h - exact > report.worst_excess) {
+                report.worst_excess = h - exact;
+                report.worst_state = show(board, Width * Width) + " (h " + std::to_string(h) + ", h* " + std::to_string(exact) + ")";
+            }
+        }
+        if (h == exact) report.exact++;
+        if (exact > 0) {
+            report.ratio_sum += static_cast<double>(h) / exact;
+            report.ratio_count++;
+        }
+    };
+
+    for (auto state : set.states) {
+        Packed::unpack(state, board);
+        auto value = heuristic.evaluate(board);
+        int h = Heuristic::cost(value);
+        check_state(h, set.distance.at(state));
+
+        int blank = Packed::find_blank(state);
+        for (int move = MoveString::up; move <= MoveString::right; move++) {
+            if (leaves_board<Width>(blank, move)) continue;
+            int destination = blank + MoveString::offset(move, Width);
+            char tile = board[destination];
+            board[blank] = tile;
+            board[destination] = 0;
+
+            int child = Heuristic::cost(heuristic.evaluate(board));
+            if (Heuristic::cost(heuristic.update(value, board, tile, destination, blank, INT_MAX)) != child) {
+                report.update_mismatches++;
+            }
+            if (set.distance.count(Packed::pack(board))) {
+                report.edges++;
+                if (h > child + 1) report.inconsistent_edges++;
+            }
+            board[destination] = tile;
+            board[blank] = 0;
+        }
+    }
+    for (const auto& deep : set.deep) {
+        Packed::unpack(deep.first, board);
+        check_state(Heuristic::cost(heuristic.evaluate(board)), deep.second);
+    }
+    return report;
+}
+
+template<int Width>
+static Report verify_spec(const std::string& spec, const ExactSet<Width>& set) {
+    try {
+        Report report = HeuristicRegistry::dispatch<Width>(spec, [&](const auto& heuristic) { return verify<Width>(heuristic, set); });
+        if (report.name != spec) report.name += " (" + spec + ")";
+        report.board = std::to_string(Width) + "x" + std::to_string(Width);
+        return report;
+    }
+    catch (const std::invalid_argument& error) {
+        Report report;
+        report.board = std::to_string(Width) + "x" + std::to_string(Width);
+        report.name = spec;
+        report.skipped = error.what();
+        return report;
+    }
+}
+
+// deep states: random walks solved exactly, trusting walking distance and linear conflict
+static void add_deep_states(ExactSet<4>& set, int count, int walk, std::mt19937& generator) {
+    MaxHeuristic<4> trusted("walking_distance,linear_conflict");
+    IdaStar<4, MaxHeuristic<4>> search(trusted);
+    for (int i = 0; i < count; i++) {
+        char board[16];
+        for (int cell = 0; cell < 16; cell++) board[cell] = static_cast<char>((cell + 1) % 16);
+        int blank = 15, previous = -1;
+        for (int step = 0; step < walk;) {
+            int move = static_cast<int>(generator() % 4);
+            if ((previous >= 0 && move == MoveString::inverse(previous)) || leaves_board<4>(blank, move)) continue;
+            blank = MoveString::apply(board, 4, blank, move);
+            previous = move;
+            step++;
+        }
+        Solution solution = search.solve(board);
+        set.deep.emplace_back(PackedState<4>::pack(board), static_cast<int>(solution.length()));
+    }
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> specs;
+    int radius = 15, deep = 20, walk = 60, radius24 = 0;
+    size_t samples = 0;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--heuristic" && has_value) specs.emplace_back(argv[++i]);
+        else if (arg == "--radius" && has_value) radius = std::stoi(argv[++i]);
+        else if (arg == "--samples" && has_value) samples = std::stoul(argv[++i]);
+        else if (arg == "--deep" && has_value) deep = std::stoi(argv[++i]);
+        else if (arg == "--walk" && has_value) walk = std::stoi(argv[++i]);
+        else if (arg == "--radius24" && has_value) radius24 = std::stoi(argv[++i]);
+        else if (arg == "--seed" && has_value) seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        else {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 2;
+        }
+    }
+    if (specs.empty()) {
+        for (const auto& info : HeuristicRegistry::list()) {
+            if (info.description.find("FILE") == std::string::npos) specs.push_back(info.name);
+        }
+    }
+
+    std::mt19937 generator(seed);
+    ExactSet<3> small;
+    breadth_first(small, INT_MAX);
+    ExactSet<4> large;
+    breadth_first(large, radius);
+    if (samples > 0 && samples < large.states.size()) {
+        std::shuffle(large.states.begin(), large.states.end(), generator);
+        large.states.resize(samples);
+    }
+    add_deep_states(large, deep, walk, generator);
+    ExactSet<5> largest;
+    if (radius24 > 0) breadth_first(largest, radius24);
+    std::cout << "3x3: " << small.states.size() << " states, 4x4: " << large.states.size() << " states within "
+              << radius << " moves + " << large.deep.size() << " deep states, 5x5: " << largest.states.size()
+              << " states within " << radius24 << " moves" << std::endl;
+
+    std::vector<Report> reports;
+    for (const auto& spec : specs) {
+        reports.push_back(verify_spec<3>(spec, small));
+        reports.push_back(verify_spec<4>(spec, large));
+        if (radius24 > 0) reports.push_back(verify_spec<5>(spec, largest));
+    }
+
+    bool broken = false;
+    std::cout << std::left << std::setw(6) << "board" << std::setw(34) << "heuristic" << std::right
+              << std::setw(10) << "states" << std::setw(10) << "over" << std::setw(9) << "jumps"
+              << std::setw(9) << "update" << std::setw(8) << "h/h*" << std::setw(8) << "exact" << "  verdict" << std::endl;
+    for (const auto& report : reports) {
+        std::cout << std::left << std::setw(6) << report.board << std::setw(34) << report.name << std::right;
+        if (!report.skipped.empty()) {
+            std::cout << "  skipped: " << report.skipped << std::endl;
+            continue;
+        }
+        bool admissible = report.overestimates == 0, consistent = admissible && report.inconsistent_edges == 0;
+        std::string verdict = consistent ? "consistent" : admissible ? "admissible, inconsistent" : "INADMISSIBLE";
+        if ((report.declared_admissible && !admissible) || (report.declared_consistent && !consistent) || report.update_mismatches > 0) {
+            verdict += " - CONTRADICTS ITS FLAGS";
+            broken = true;
+        }
+        std::cout << std::setw(10) << report.states << std::setw(10) << report.overestimates
+                  << std::setw(9) << report.inconsistent_edges << std::setw(9) << report.update_mismatches
+                  << std::setw(8) << std::fixed << std::setprecision(3)
+                  << (report.ratio_count ? report.ratio_sum / static_cast<double>(report.ratio_count) : 1.0)
+                  << std::setw(7) << std::setprecision(1) << 100.0 * static_cast<double>(report.exact) / static_cast<double>(std::max(report.states, 1ULL)) << "%"
+                  << "  " << verdict << std::endl;
+        if (!report.worst_state.empty()) std::cout << "      worst: " << report.worst_state << std::endl;
+    }
+    return broken ? 1 : 0;
+}
@@ -0,0 +1,141 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "EightPuzzleTable.h"
+#include "EndgameTable.h"
+#include "IdaStar.h"
+#include "InstanceGenerator.h"
+#include "MaxHeuristic.h"
+
+
+//// instance_gen [--width W] [--count N] [--seed S] [--output FILE] [--binary]
+////              [--distance D[,D...]] [--eight-table FILE | --endgame FILE | --heuristic SPEC]
+//// writes N random solvable boards in the InstanceReader format, uniform over
+//// every solvable board - or, with --distance, N boards exactly D moves from the
+//// goal for every D given (a stratified corpus). The distances come from the
+//// 3x3 table, the endgame table (4x4, D up to its radius) or an optimal IDA*
+//// solve with the maximum of SPEC (walking_distance,linear_conflict by default,
+//// pdb:FILE components make it fast on 4x4).
+
+struct Options {
+    int width = 4;
+    unsigned long count = 10;
+    uint64_t seed = 1;
+    std::string output;
+    bool binary = false;
+    std::vector<int> distances;
+    std::string eight_table;
+    std::string endgame;
+    std::string heuristic = "walking_distance,linear_conflict";
+};
+
+static void write_board(std::ostream& out, const char* board, int width, bool binary) {
+    int cells = width * width;
+    if (binary) {
+        out.put(static_cast<char>(width));
+        out.write(board, cells);
+        return;
+    }
+    for (int cell = 0; cell < cells; cell++) out << (cell > 0 ? " " : "") << static_cast<int>(board[cell]);
+    out << '\n';
+}
+
+template<int Width>
+static InstanceGenerator::DistanceOracle solving_oracle(const std::string& spec) {
+    auto heuristic = std::make_shared<MaxHeuristic<Width>>(spec);
+    auto search = std::make_shared<IdaStar<Width, MaxHeuristic<Width>>>(*heuristic);
+    //// the search holds on to the heuristic, the oracle to both
+    return [heuristic, search](const char* board) { return static_cast<int>(search->solve(board).length()); };
+}
+
+static InstanceGenerator::DistanceOracle make_oracle(const Options& options, EightPuzzleTable& eight, EndgameTable& endgame) {
+    if (!options.eight_table.empty()) {
+        if (options.width != EightPuzzleTable::width) throw std::invalid_argument("--eight-table needs --width 3");
+        eight.open(options.eight_table);
+        return [&eight](const char* board) { return eight.distance(board); };
+    }
+    if (!options.endgame.empty()) {
+        if (options.width != Solver::Node::grid_size) throw std::invalid_argument("--endgame needs --width 4");
+        endgame.load(options.endgame);
+        return [&endgame](const char* board) { return endgame.distance(EndgameTable::Packed::pack(board)); };
+    }
+    if (options.width == 3) return solving_oracle<3>(options.heuristic);
+    if (options.width == 4) return solving_oracle<4>(options.heuristic);
+    throw std::invalid_argument("--distance needs a 3x3 or 4x4 board");
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--width" && has_value) options.width = std::stoi(argv[++i]);
+        else if (arg == "--count" && has_value) options.count = std::stoul(argv[++i]);
+        else if (arg == "--seed" && has_value) options.seed = std::stoull(argv[++i]);
+        else if (arg == "--output" && has_value) options.output = argv[++i];
+        else if (arg == "--binary") options.binary = true;
+        else if (arg == "--distance" && has_value) {
+            std::stringstream items(argv[++i]);
+            std::string item;
+            while (std::getline(items, item, ',')) options.distances.push_back(std::stoi(item));
+        }
+        else if (arg == "--eight-table" && has_value) options.eight_table = argv[++i];
+        else if (arg == "--endgame" && has_value) options.endgame = argv[++i];
+        else if (arg == "--heuristic" && has_value) options.heuristic = argv[++i];
+        else {
+            std::cerr << "usage: " << argv[0] << " [--width W] [--count N] [--seed S] [--output FILE] [--binary]"
+                      << " [--distance D[,D...]] [--eight-table FILE | --endgame FILE | --heuristic SPEC]" << std::endl;
+            return 2;
+        }
+    }
+
+    try {
+        InstanceGenerator generator(options.width, options.seed);
+        std::ofstream file;
+        if (!options.output.empty()) {
+            file.open(options.output, options.binary ? std::ios::binary : std::ios::out);
+            if (!file) throw std::runtime_error("cannot open " + options.output);
+        }
+        std::ostream& out = options.output.empty() ? std::cout : file;
+        std::vector<char> board(static_cast<size_t>(options.width * options.width));
+        auto start = std::chrono::steady_clock::now();
+        unsigned long written = 0;
+
+        if (options.distances.empty()) {
+            for (; written < options.count; written++) {
+                generator.random(board.data());
+                write_board(out, board.data(), options.width, options.binary);
+            }
+        } else {
+            EightPuzzleTable eight;
+            EndgameTable endgame;
+            InstanceGenerator::DistanceOracle oracle = make_oracle(options, eight, endgame);
+            for (int distance : options.distances) {
+                if (!options.binary) out << "# distance " << distance << '\n';
+                for (unsigned long i = 0; i < options.count; i++, written++) {
+                    if (!generator.at_distance(distance, oracle, board.data())) {
+                        throw std::runtime_error("no board found " + std::to_string(distance) + " moves from the goal");
+                    }
+                    write_board(out, board.data(), options.width, options.binary);
+                }
+            }
+        }
+        out.flush();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cerr << written << " boards in " << seconds << " s (" << written / std::max(seconds, 1e-9) << " per second)" << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -3,20 +3,122 @@
 #include <random>
 #include <list>
 #include <algorithm>
+#include <memory>
 #include "Solver.h"
+#include "ExternalSolver.h"
+#include "InstanceStream.h"
+#include "SolutionCache.h"
+#include "EndgameTable.h"
+#include "EightPuzzleTable.h"
+#include "HeuristicRegistry.h"
+#include "InstanceGenerator.h"
+#include "Inversions.h"
+#include "BeamSearch.h"
+#include "IdaStar.h"
+#include "TwentyFourSolver.h"
+#include "LargeBoardSolver.h"
+#include "PathOptimizer.h"
 
 
 char* generate_target();
 char* generate_random_target();
 void print_game_state(char*&);
+int run_batch(int argc, char** argv);
 // used to represent game state graph nodes
 
 
-int main() {
+int main(int argc, char** argv) {
+    //// --build-endgame <file> <radius> precomputes the goal neighbourhood once,
+    //// --endgame <file> lets every solve below finish through it
+    EndgameTable endgame_table;
+    bool endgame_loaded = false;
+    std::string heuristic = Solver::default_heuristic;
+    bool heuristic_given = false;
+    bool partial_expansion = false, frontier = false, breadth_first = false;
+    int upper_bound = 0, beam_width = 0, beam_restarts = 0;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        try {
+            if (arg == "--build-endgame" && i + 2 < argc) {
+                EndgameTable::build(argv[i + 1], std::stoi(argv[i + 2]));
+                EndgameTable built(argv[i + 1]);
+                std::cout << "endgame table with " << built.size() << " states written to " << argv[i + 1] << std::endl;
+                return 0;
+            }
+            if (arg == "--endgame" && i + 1 < argc) {
+                endgame_table.load(argv[i + 1]);
+                endgame_loaded = true;
+            }
+        }
+        catch (const std::runtime_error& e) {
+            std::cerr << e.what() << std::endl; // the table file could not be written or read
+            return 1;
+        }
+        //// --heuristic <spec> picks the estimate by name (--list-heuristics shows them),
+        //// e.g. walking_distance, pdb:7-8.pdb or walking_distance,pdb:7-8.pdb,pdb_dual:7-8.pdb
+        if (arg == "--heuristic" && i + 1 < argc) {
+            heuristic = argv[i + 1];
+            heuristic_given = true;
+        }
+        //// --partial-expansion runs EPEA*, building only the children whose f is the node's
+        if (arg == "--partial-expansion") {
+            partial_expansion = true;
+        }
+        //// --frontier keeps only the open list (frontier search), for instances whose closed list would not fit;
+        //// it needs a consistent --heuristic such as walking_distance
+        if (arg == "--frontier") {
+            frontier = true;
+        }
+        //// --breadth-first searches layer by layer within --upper-bound <moves> (or deepening without one)
+        if (arg == "--breadth-first") {
+            breadth_first = true;
+        }
+        if (arg == "--upper-bound" && i + 1 < argc) {
+            upper_bound = std::stoi(argv[i + 1]);
+        }
+        //// --beam <width> runs beam search instead, quick but not optimal; --beam-restarts <n>
+        //// tries again n times with twice the width each time
+        if (arg == "--beam" && i + 1 < argc) {
+            beam_width = std::stoi(argv[i + 1]);
+        }
+        if (arg == "--beam-restarts" && i + 1 < argc) {
+            beam_restarts = std::stoi(argv[i + 1]);
+        }
+        if (arg == "--list-heuristics") {
+            for (const auto& info : HeuristicRegistry::list()) {
+                std::cout << info.name << (info.is_admissible ? " [admissible]" : " [inadmissible]")
+                          << (info.is_consistent ? "[consistent]" : "") << " - " << info.description << std::endl;
+            }
+            return 0;
+        }
+    }
 
+    //// any of --batch, --input, --output, --binary-input, --binary-output, --cache
+    //// switches to streaming many instances instead of a single random one;
+    //// 5x5 instances there are solved by IDA* over --pdb24 <file> on --threads <n>, wider ones
+    //// (or all, with --decompose) row by row and column by column, quickly but not optimally
+    //// (--keep-inverses leaves in the moves undone right away); --post-optimize <seconds> then
+    //// shortens those and the inadmissible 4x4 ones in windows of --window <k> moves (0 seconds:
+    //// until it stops finding any); --beam <width> (and --beam-restarts <n>) solves 4x4 and 5x5
+    //// by beam search instead, the 5x5 ones over --pdb24 if given, else --heuristic;
+    //// --endgame <file> finishes the 4x4 Solver's searches through the table
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--batch" || arg == "--input" || arg == "--output" || arg == "--binary-input" || arg == "--binary-output" || arg == "--cache") {
+            return run_batch(argc, argv);
+        }
+    }
+
+    //// --external <dir> keeps the frontier in bucket files inside <dir>,
+    //// running it again on the same <dir> resumes an interrupted search (--heuristic has to
+    //// be admissible there, walking_distance when not given)
+    bool external = argc >= 3 && std::string(argv[1]) == "--external";
 
     std::cout << "initial permutation:"<< std::endl;
     char* base_game_state = generate_random_target();
+    if (external) {
+        ExternalSolver::load_start_state(argv[2], base_game_state);
+    }
 //    std::vector<char> vec;
 //    vec = {2,       10,      8,       7,
 //           1,       4,       14,      3,
@@ -29,38 +131,64 @@ int main() {
     /// start measuring time
     auto start = std::chrono::high_resolution_clock::now();
 
+    if (external) {
+        ExternalSolver external_solver(base_game_state, argv[2], heuristic_given ? heuristic : ExternalSolver::default_heuristic);
+        Solution solution = external_solver.solve();
+        std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+        std::cout << "\nfeasible solution: " << solution.moves.to_string() << "\n";
+        for (size_t step = 0; step <= solution.length(); step++) {
+            solution.board_after(step, base_game_state);
+            print_game_state(base_game_state);
+        }
+        std::cout << "\nshortest path consists of " << solution.length() << " steps" << std::endl;
+        std::cout << "nodes expanded: " << external_solver.get_nodes_expanded() << std::endl;
+        std::cout << "time spent searching the solution: " << elapsed.count() << std::endl;
+        delete[] base_game_state; // the external solver only borrows the board
+        return 0;
+    }
+
     //// here the search for solution
     //// (A* algorithm) begins
-    auto solver = new Solver(base_game_state);
-    auto feasible_solutions = solver->solve();
+    //// a heuristic spec that does not parse, or one the chosen search cannot use
+    //// (--frontier with an inconsistent one), ends here with its message
+    auto solver = new Solver(base_game_state, heuristic);
+    Solution solution;
+    try {
+        solver->set_partial_expansion(partial_expansion);
+        solver->set_frontier_search(frontier);
+        solver->set_breadth_first(breadth_first);
+        solver->set_upper_bound(upper_bound);
+        if (endgame_loaded) solver->set_endgame_table(&endgame_table);
+        if (beam_width > 0) solver->set_beam_search(static_cast<size_t>(beam_width), beam_restarts);
+        solution = solver->solve(); // base_game_state is released together with the search
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        delete solver;
+        return 1;
+    }
 
     //// stop measuring elapsed time
     auto finish = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> elapsed = finish - start;
 
-
-    int current_min_val = INT32_MAX;
-
     //// PRINT SOLUTION
-    for (auto candidate : feasible_solutions) {
-        Solver::Node* tmp_node = candidate;
-        int num_of_steps = 0;
-        std::cout<< "\nfeasible solution:\n";
-        print_game_state(candidate->game_state);
-        while (tmp_node->parent != nullptr) {
-            num_of_steps++;
-            print_game_state(tmp_node->parent->game_state);
-            tmp_node = tmp_node->parent;
-        }
-        std::cout << "solution needed to perform: " << num_of_steps << " steps\n";
-
-        current_min_val = std::min(current_min_val, num_of_steps);
+    std::cout<< "\nfeasible solution: " << solution.moves.to_string() << "\n";
+    char board[Solver::Node::grid_size * Solver::Node::grid_size];
+    char* board_pointer = board;
+    for (size_t step = 0; step <= solution.length(); step++) {
+        solution.board_after(step, board);
+        print_game_state(board_pointer);
     }
 
-    std::cout << "\nshortest path consists of " << current_min_val << " steps" << std::endl;
-//    std::cout << "number of iterations of this algorithm: " << num_of_iterations << " steps" << std::endl;
+    std::cout << "\nshortest path consists of " << solution.length() << " steps" << std::endl;
+    std::cout << "number of iterations of this algorithm: " << solution.nodes_expanded << " steps" << std::endl;
+    std::cout << "nodes generated: " << solver->get_nodes_generated() << std::endl;
+    if (frontier || breadth_first) std::cout << "largest frontier: " << solver->get_peak_frontier() << " nodes" << std::endl;
     std::cout << "time spent searching the solution: " << elapsed.count() << std::endl;
 
+    delete solver;
     return 0;
 }
 
@@ -73,7 +201,7 @@ int main() {
 
 
 char* generate_target() {
-    char *target = static_cast<char *>(malloc(sizeof(char) * Solver::Node::grid_size * Solver::Node::grid_size));
+    char *target = new char[Solver::Node::grid_size * Solver::Node::grid_size]; // freed by the solver with delete[]
     for (char i = 0; i < Solver::Node::grid_size * Solver::Node::grid_size; i++)
         target[i] = static_cast<char> (i + 1);
 
@@ -82,17 +210,289 @@ char* generate_target() {
     return target;
 }
 
+// uniform over the solvable boards, a blind shuffle would hand the solver an unsolvable one half the time
 char* generate_random_target() {
     char *target = generate_target();
-    std::random_device rd;
-    std::mt19937 mt(rd());
+    InstanceGenerator generator(Solver::Node::grid_size, std::random_device{}());
+    generator.random(target);
+    return target;
+}
 
-    std::shuffle(target, target + Solver::Node::grid_size * Solver::Node::grid_size, mt);
 
-    return target;
+
+
+// what the batch mode keeps between instances
+struct BatchContext {
+    std::unique_ptr<SolutionCache> cache;
+    std::unique_ptr<EndgameTable> endgame_table; // only with --endgame, for the 4x4 Solver
+    std::string eight_table_path = "eight_puzzle.tbl";
+    EightPuzzleTable eight_table; // opened (and generated if needed) on the first 3x3 instance
+    std::string twenty_four_database;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    std::unique_ptr<TwentyFourSolver> twenty_four; // loaded on the first 5x5 instance
+    bool decompose = false;
+    bool cancel_inverses = true;
+    std::unique_ptr<LargeBoardSolver> large_board; // set up on the first instance it takes
+    std::unique_ptr<PathOptimizer> post_optimizer; // only with --post-optimize
+    size_t beam_width = 0; // 0: the optimal engines
+    int beam_restarts = 0;
+    std::string heuristic = Solver::default_heuristic;
+    bool partial_expansion = false;
+    bool frontier = false;
+    bool breadth_first = false;
+    int upper_bound = 0;
+};
+
+// the suboptimal paths through the post-optimizer, if there is one
+static void post_optimize(const Instance& instance, BatchContext& context, SolveRecord& record) {
+    if (!context.post_optimizer || record.length <= 0) return;
+    std::vector<PathOptimizer::tile_type> game_state(instance.tiles.begin(), instance.tiles.end());
+    record.moves = context.post_optimizer->optimize(game_state.data(), instance.width, record.moves);
+    record.length = static_cast<int>(record.moves.size());
+    record.nodes_expanded += context.post_optimizer->get_nodes_expanded();
 }
 
+static bool is_admissible(const std::string& heuristic) {
+    for (const auto& info : HeuristicRegistry::list()) {
+        if (info.name == heuristic) return info.is_admissible;
+    }
+    return true; // pattern databases and maxima of them
+}
+
+SolveRecord solve_instance(const Instance& instance, BatchContext& context) {
+    SolveRecord record;
+    record.id = instance.id;
+    auto start = std::chrono::high_resolution_clock::now();
 
+    if (!Inversions::is_solvable(instance.tiles.data(), instance.width)) {
+        return record; // length -1, before any table or search is set up for it
+    }
+    if (instance.width > TwentyFourSolver::width || (context.decompose && instance.width >= EightPuzzleTable::width)) {
+        //// no optimal search gets this far - solve the board down to a 3x3 line by line
+        if (!context.eight_table.is_open()) context.eight_table.open(context.eight_table_path);
+        if (!context.large_board) context.large_board.reset(new LargeBoardSolver(context.eight_table));
+        context.large_board->set_cancel_inverses(context.cancel_inverses);
+        std::vector<LargeBoardSolver::tile_type> game_state(instance.tiles.begin(), instance.tiles.end());
+        record.moves = context.large_board->solve(game_state.data(), instance.width);
+        record.length = static_cast<int>(record.moves.size());
+        record.nodes_expanded = context.large_board->get_nodes_expanded();
+        post_optimize(instance, context, record);
+    }
+    else if (instance.width == EightPuzzleTable::width) {
+        //// 3x3 - no search at all, just walk down the distance table
+        if (!context.eight_table.is_open()) context.eight_table.open(context.eight_table_path);
+        char game_state[EightPuzzleTable::tiles];
+        std::copy(instance.tiles.begin(), instance.tiles.end(), game_state);
+        try {
+            Solution solution = context.eight_table.solve(game_state);
+            record.moves = solution.moves;
+            record.length = static_cast<int>(solution.length());
+            record.nodes_expanded = solution.nodes_expanded;
+        }
+        catch (const std::runtime_error& e) {
+            // not solvable, reported with length -1
+        }
+    }
+    else if (instance.width == 2) {
+        //// 2x2 - twelve reachable boards, plain IDA* over the Manhattan distance is optimal at once
+        std::vector<char> game_state(instance.tiles.begin(), instance.tiles.end());
+        Solution solution = IdaStar<2, Manhattan<2>>(Manhattan<2>()).solve(game_state.data());
+        record.moves = solution.moves;
+        record.length = static_cast<int>(solution.length());
+        record.nodes_expanded = solution.nodes_expanded;
+    }
+    else if (instance.width == Solver::Node::grid_size) {
+        char* game_state = new char[Solver::Node::grid_size * Solver::Node::grid_size]; // owned by the solver's base node
+        std::copy(instance.tiles.begin(), instance.tiles.end(), game_state);
+
+        SolutionCache* cache = context.cache.get();
+        if (cache != nullptr && cache->lookup(game_state, record.moves)) {
+            delete[] game_state;
+            record.length = static_cast<int>(record.moves.size());
+            std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+            record.seconds = elapsed.count();
+            return record;
+        }
+        std::vector<char> start_state(game_state, game_state + Solver::Node::grid_size * Solver::Node::grid_size);
+
+        Solver solver(game_state, context.heuristic);
+        solver.set_verbose(false);
+        solver.set_partial_expansion(context.partial_expansion);
+        solver.set_frontier_search(context.frontier);
+        solver.set_breadth_first(context.breadth_first);
+        solver.set_upper_bound(context.upper_bound);
+        solver.set_endgame_table(context.endgame_table.get());
+        solver.set_beam_search(context.beam_width, context.beam_restarts);
+        try {
+            Solution solution = solver.solve();
+            record.moves = solution.moves;
+            record.length = static_cast<int>(solution.length());
+            record.nodes_expanded = solver.get_nodes_expanded();
+            //// the cache only takes shortest paths - its key knows nothing of heuristic or mode
+            bool optimal = context.beam_width == 0 && is_admissible(context.heuristic);
+            if (!optimal) post_optimize(instance, context, record);
+            else if (cache != nullptr) cache->insert(start_state.data(), record.moves);
+        }
+        catch (const std::runtime_error& e) {
+            // solvability is checked above - this is a beam that lost every path
+            // (or a bounded search that found none), reported with length -1
+            record.nodes_expanded = solver.get_nodes_expanded();
+        }
+    }
+    else if (instance.width == TwentyFourSolver::width && context.beam_width > 0) {
+        //// 5x5 by beam search, over the reflected database when there is one
+        std::string heuristic = context.twenty_four_database.empty() ? context.heuristic : "pdb_reflected:" + context.twenty_four_database;
+        char game_state[TwentyFourSolver::tiles];
+        std::copy(instance.tiles.begin(), instance.tiles.end(), game_state);
+        bool lost = false;
+        Solution solution = HeuristicRegistry::dispatch<TwentyFourSolver::width>(heuristic, [&](const auto& estimator) {
+            BeamSearch<TwentyFourSolver::width, std::decay_t<decltype(estimator)>> beam(estimator, context.beam_width, context.threads);
+            beam.set_restarts(context.beam_restarts);
+            try {
+                return beam.solve(game_state);
+            }
+            catch (const std::runtime_error& e) {
+                // solvable (checked above), so every beam lost the way - length -1 for this
+                // instance only, a database that does not load still stops the batch
+                lost = true;
+                Solution none;
+                none.nodes_expanded = beam.get_nodes_expanded();
+                return none;
+            }
+        });
+        record.nodes_expanded = solution.nodes_expanded;
+        if (!lost) {
+            record.moves = solution.moves;
+            record.length = static_cast<int>(solution.length());
+            post_optimize(instance, context, record);
+        }
+    }
+    else if (instance.width == TwentyFourSolver::width) {
+        //// 5x5 - IDA* over the reflected pattern database, split between the threads
+        if (!context.twenty_four) {
+            if (context.twenty_four_database.empty()) {
+                throw std::invalid_argument("5x5 instances need a pattern database, --pdb24 FILE");
+            }
+            context.twenty_four.reset(new TwentyFourSolver(context.twenty_four_database, context.threads));
+        }
+        char game_state[TwentyFourSolver::tiles];
+        std::copy(instance.tiles.begin(), instance.tiles.end(), game_state);
+        Solution solution = context.twenty_four->solve(game_state);
+        record.moves = solution.moves;
+        record.length = static_cast<int>(solution.length());
+        record.nodes_expanded = solution.nodes_expanded;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+    record.seconds = elapsed.count();
+    return record;
+}
+
+int run_batch(int argc, char** argv) {
+    std::string input_path = "-", output_path = "-", cache_path, eight_table_path, heuristic, twenty_four_database, endgame_path;
+    bool binary_input = false, binary_output = false, partial_expansion = false, frontier = false, breadth_first = false;
+    bool decompose = false, cancel_inverses = true;
+    int upper_bound = 0, threads = 0, window = 16, beam_width = 0, beam_restarts = 0;
+    double post_optimize_seconds = -1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--input" && i + 1 < argc) input_path = argv[++i];
+        else if (arg == "--output" && i + 1 < argc) output_path = argv[++i];
+        else if (arg == "--cache" && i + 1 < argc) cache_path = argv[++i];
+        else if (arg == "--endgame" && i + 1 < argc) endgame_path = argv[++i];
+        else if (arg == "--eight-table" && i + 1 < argc) eight_table_path = argv[++i];
+        else if (arg == "--heuristic" && i + 1 < argc) heuristic = argv[++i];
+        else if (arg == "--partial-expansion") partial_expansion = true;
+        else if (arg == "--frontier") frontier = true;
+        else if (arg == "--breadth-first") breadth_first = true;
+        else if (arg == "--upper-bound" && i + 1 < argc) upper_bound = std::stoi(argv[++i]);
+        else if (arg == "--pdb24" && i + 1 < argc) twenty_four_database = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = std::stoi(argv[++i]);
+        else if (arg == "--decompose") decompose = true;
+        else if (arg == "--keep-inverses") cancel_inverses = false;
+        else if (arg == "--post-optimize" && i + 1 < argc) post_optimize_seconds = std::stod(argv[++i]);
+        else if (arg == "--window" && i + 1 < argc) window = std::stoi(argv[++i]);
+        else if (arg == "--beam" && i + 1 < argc) beam_width = std::stoi(argv[++i]);
+        else if (arg == "--beam-restarts" && i + 1 < argc) beam_restarts = std::stoi(argv[++i]);
+        else if (arg == "--binary-input") binary_input = true;
+        else if (arg == "--binary-output") binary_output = true;
+    }
+
+    std::ifstream input_file;
+    std::ofstream output_file;
+    if (input_path != "-") {
+        input_file.open(input_path, binary_input ? std::ios::binary : std::ios::in);
+        if (!input_file) {
+            std::cerr << "cannot open " << input_path << std::endl;
+            return 1;
+        }
+    }
+    if (output_path != "-") {
+        output_file.open(output_path, binary_output ? std::ios::binary : std::ios::out);
+        if (!output_file) {
+            std::cerr << "cannot open " << output_path << std::endl;
+            return 1;
+        }
+    }
+
+    BatchContext context;
+    if (!cache_path.empty()) {
+        context.cache.reset(new SolutionCache(Solver::Node::grid_size, cache_path));
+    }
+    if (!endgame_path.empty()) {
+        try {
+            context.endgame_table.reset(new EndgameTable(endgame_path));
+        }
+        catch (const std::runtime_error& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+    if (!eight_table_path.empty()) {
+        context.eight_table_path = eight_table_path;
+    }
+    if (!heuristic.empty()) {
+        context.heuristic = heuristic;
+    }
+    context.partial_expansion = partial_expansion;
+    context.frontier = frontier;
+    context.breadth_first = breadth_first;
+    context.upper_bound = upper_bound;
+    context.twenty_four_database = twenty_four_database;
+    if (threads > 0) context.threads = threads;
+    context.decompose = decompose;
+    context.cancel_inverses = cancel_inverses;
+    if (beam_width > 0) context.beam_width = static_cast<size_t>(beam_width);
+    context.beam_restarts = beam_restarts;
+    if (post_optimize_seconds >= 0) {
+        try {
+            context.post_optimizer.reset(new PathOptimizer(window, context.threads));
+        }
+        catch (const std::invalid_argument& e) {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+        context.post_optimizer->set_time_budget(post_optimize_seconds);
+    }
+
+    InstanceReader reader(input_path == "-" ? std::cin : input_file, binary_input);
+    ResultWriter writer(output_path == "-" ? std::cout : output_file, binary_output);
+    Instance instance;
+    try {
+        while (reader.next(instance)) {
+            writer.write(solve_instance(instance, context));
+        }
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << e.what() << std::endl; // a 5x5 database that does not load
+        return 1;
+    }
+    return 0;
+}
 
 
 void print_game_state(char*& game){
@@ -0,0 +1,244 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include "EndgameTable.h"
+#include "IdaStar.h"
+#include "InterleavedIdaStar.h"
+#include "ParallelIdaStar.h"
+#include "InstanceGenerator.h"
+#include "InstanceStream.h"
+#include "Inversions.h"
+#include "PatternDatabase.h"
+#include "PatternHeuristic.h"
+
+
+//// pdb_bench --pdb exact.pdb --pdb mod3.pdb --pdb min4.pdb [--input instances.txt]
+////           [--instances N] [--walk LENGTH] [--seed S] [--prune LENGTH]
+////           [--threads N] [--interleave N] [--tt-mb MB] [--tt-policy depth|always]
+////           [--perimeter ENDGAME_FILE] [--reflect]
+//// solves the same instances with IDA* over every database and prints table size,
+//// lookup cost, nodes and time side by side; the first database is the baseline.
+//// --prune drops move sequences up to LENGTH that another one covers (MovePruning),
+//// --tt-mb gives the search a transposition table of that size, --threads splits
+//// every iteration at the root (ParallelIdaStar), --interleave runs N searches
+//// side by side on one thread (InterleavedIdaStar, experimental), --perimeter stops every
+//// search at the rim of a table built by wsi1 --build-endgame (4x4, perimeter search),
+//// --reflect takes the larger of the board's and its mirror's lookups (ReflectedPatternHeuristic).
+//// 3x3, 4x4 and 5x5 databases.
+
+struct BenchRow {
+    std::string path;
+    size_t bytes = 0;
+    double nanoseconds_per_lookup = 0;
+    unsigned long long nodes = 0;
+    double seconds = 0;
+    std::vector<size_t> lengths;
+};
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct SearchOptions {
+    int prune = 2;
+    int threads = 1;
+    int interleave = 1;
+    size_t table_megabytes = 0;
+    TranspositionTable::policy table_policy = TranspositionTable::depth_preferred;
+    const EndgameTable* perimeter = nullptr;
+    bool reflect = false;
+};
+
+template<int Width, class Heuristic>
+static void solve_all(const Heuristic& heuristic, const SearchOptions& options, const std::vector<Instance>& instances, BenchRow& row) {
+    MovePruning pruning(options.prune);
+    std::unique_ptr<TranspositionTable> table;
+    if (options.table_megabytes > 0) table.reset(new TranspositionTable(options.table_megabytes, options.table_policy));
+    IdaStar<Width, Heuristic> search(heuristic, pruning);
+    search.use_table(table.get());
+    search.use_perimeter(options.perimeter);
+    ParallelIdaStar<Width, Heuristic> parallel_search(heuristic, options.threads, table.get(), pruning);
+    parallel_search.use_perimeter(options.perimeter);
+    auto start = std::chrono::steady_clock::now();
+    if (options.interleave > 1) {
+        if (options.perimeter != nullptr) throw std::invalid_argument("--perimeter does not combine with --interleave");
+        InterleavedIdaStar<Width, Heuristic> interleaved(heuristic, options.interleave, pruning);
+        interleaved.use_table(table.get());
+        std::vector<std::vector<char>> boards;
+        for (const auto& instance : instances) boards.emplace_back(instance.tiles.begin(), instance.tiles.end());
+        for (const auto& solution : interleaved.solve(boards)) {
+            row.nodes += solution.nodes_expanded;
+            row.lengths.push_back(solution.length());
+        }
+        row.seconds = seconds_since(start);
+        return;
+    }
+    for (const auto& instance : instances) {
+        std::vector<char> board(instance.tiles.begin(), instance.tiles.end());
+        Solution solution = options.threads > 1 ? parallel_search.solve(board.data()) : search.solve(board.data());
+        row.nodes += solution.nodes_expanded;
+        row.lengths.push_back(solution.length());
+    }
+    row.seconds = seconds_since(start);
+}
+
+template<int Width>
+static void bench(const PatternDatabase& database, const SearchOptions& options, const std::vector<Instance>& instances, BenchRow& row) {
+    //// lookup cost: one stored-value fetch per pattern over every instance, repeated
+    volatile int sink = 0;
+    unsigned long long lookups = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < 2000; round++) {
+        for (const auto& instance : instances) {
+            char board[Width * Width];
+            std::copy(instance.tiles.begin(), instance.tiles.end(), board);
+            for (int p = 0; p < static_cast<int>(database.get_patterns().size()); p++) {
+                sink = sink + database.lookup(p, board);
+                lookups++;
+            }
+        }
+    }
+    row.nanoseconds_per_lookup = seconds_since(start) * 1e9 / static_cast<double>(std::max(lookups, 1ULL));
+
+    if (options.reflect) {
+        solve_all<Width>(ReflectedPatternHeuristic(database), options, instances, row);
+    } else if (database.get_encoding() == PatternDatabase::modulo_three) {
+        solve_all<Width>(ModuloPatternHeuristic(database), options, instances, row);
+    } else {
+        solve_all<Width>(PatternHeuristic(database), options, instances, row);
+    }
+}
+
+static std::vector<Instance> random_walks(int width, int count, int walk, unsigned seed) {
+    InstanceGenerator generator(width, seed);
+    std::vector<Instance> instances;
+    std::vector<char> board(static_cast<size_t>(width * width));
+    for (int i = 0; i < count; i++) {
+        Instance instance;
+        instance.id = static_cast<unsigned long>(i);
+        instance.width = width;
+        generator.walk(walk, board.data());
+        instance.tiles.assign(board.begin(), board.end());
+        instances.push_back(instance);
+    }
+    return instances;
+}
+
+// one pass over every board before any search starts, an unsolvable one would abort the run
+static void drop_unsolvable(std::vector<Instance>& instances) {
+    if (instances.empty()) return;
+    int width = instances.front().width;
+    size_t cells = static_cast<size_t>(width * width);
+    std::vector<char> boards;
+    boards.reserve(instances.size() * cells);
+    for (const auto& instance : instances) {
+        if (instance.width != width) throw std::runtime_error("instances of different widths");
+        boards.insert(boards.end(), instance.tiles.begin(), instance.tiles.end());
+    }
+    std::vector<uint8_t> solvable(instances.size());
+    size_t kept = Inversions::is_solvable_batch(boards.data(), instances.size(), width, solvable.data());
+    if (kept == instances.size()) return;
+    std::cerr << "skipping " << instances.size() - kept << " unsolvable instances" << std::endl;
+    size_t next = 0;
+    for (size_t i = 0; i < instances.size(); i++) {
+        if (solvable[i]) instances[next++] = instances[i];
+    }
+    instances.resize(next);
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    std::string input;
+    int count = 20, walk = 60;
+    SearchOptions options;
+    std::string perimeter_path;
+    EndgameTable perimeter;
+    unsigned seed = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--pdb" && has_value) paths.emplace_back(argv[++i]);
+        else if (arg == "--input" && has_value) input = argv[++i];
+        else if (arg == "--instances" && has_value) count = std::stoi(argv[++i]);
+        else if (arg == "--walk" && has_value) walk = std::stoi(argv[++i]);
+        else if (arg == "--seed" && has_value) seed = static_cast<unsigned>(std::stoul(argv[++i]));
+        else if (arg == "--prune" && has_value) options.prune = std::stoi(argv[++i]);
+        else if (arg == "--threads" && has_value) options.threads = std::stoi(argv[++i]);
+        else if (arg == "--interleave" && has_value) options.interleave = std::stoi(argv[++i]);
+        else if (arg == "--tt-mb" && has_value) options.table_megabytes = std::stoul(argv[++i]);
+        else if (arg == "--tt-policy" && has_value) options.table_policy = TranspositionTable::parse_policy(argv[++i]);
+        else if (arg == "--perimeter" && has_value) perimeter_path = argv[++i];
+        else if (arg == "--reflect") options.reflect = true;
+        else {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 2;
+        }
+    }
+    if (paths.empty()) {
+        std::cerr << "usage: " << argv[0] << " --pdb FILE [--pdb FILE...] [--input FILE]"
+                  << " [--instances N] [--walk LENGTH] [--seed S] [--prune LENGTH]"
+                  << " [--threads N] [--interleave N] [--tt-mb MB] [--tt-policy depth|always]"
+                  << " [--perimeter ENDGAME_FILE] [--reflect]" << std::endl;
+        return 2;
+    }
+
+    try {
+        if (!perimeter_path.empty()) {
+            perimeter.load(perimeter_path);
+            options.perimeter = &perimeter;
+        }
+        std::vector<BenchRow> rows;
+        std::vector<Instance> instances;
+        for (const auto& path : paths) {
+            PatternDatabase database(path);
+            int width = database.get_width();
+            if (instances.empty()) {
+                if (input.empty()) {
+                    instances = random_walks(width, count, walk, seed);
+                } else {
+                    std::ifstream in(input);
+                    if (!in) throw std::runtime_error("cannot open " + input);
+                    InstanceReader reader(in, false);
+                    Instance instance;
+                    while (reader.next(instance)) instances.push_back(instance);
+                    drop_unsolvable(instances);
+                }
+            }
+            for (const auto& instance : instances) {
+                if (instance.width != width) throw std::runtime_error(path + " does not match the instance width");
+            }
+
+            BenchRow row;
+            row.path = path;
+            row.bytes = database.size_in_bytes();
+            if (width == 3) bench<3>(database, options, instances, row);
+            else if (width == 4) bench<4>(database, options, instances, row);
+            else if (width == 5) bench<5>(database, options, instances, row);
+            else throw std::runtime_error("pdb_bench handles 3x3, 4x4 and 5x5 databases");
+            rows.push_back(row);
+        }
+
+        std::cout << std::left << std::setw(28) << "database" << std::right << std::setw(12) << "bytes"
+                  << std::setw(12) << "ns/lookup" << std::setw(14) << "nodes" << std::setw(10) << "seconds"
+                  << std::setw(12) << "nodes/base" << "  optimal" << std::endl;
+        for (const auto& row : rows) {
+            std::cout << std::left << std::setw(28) << row.path << std::right << std::setw(12) << row.bytes
+                      << std::setw(12) << std::fixed << std::setprecision(1) << row.nanoseconds_per_lookup
+                      << std::setw(14) << row.nodes << std::setw(10) << std::setprecision(3) << row.seconds
+                      << std::setw(12) << std::setprecision(2)
+                      << static_cast<double>(row.nodes) / static_cast<double>(std::max(rows[0].nodes, 1ULL))
+                      << "  " << (row.lengths == rows[0].lengths ? "same" : "DIFFERENT") << std::endl;
+        }
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,68 @@
+//
+// Created by adame on 10/19/2026.
+//
+
+#include <iostream>
+#include <stdexcept>
+#include "PatternDatabase.h"
+#include "PatternDatabaseBuilder.h"
+
+
+//// pdb_gen --width 4 --partition 1,2,3,4,5,6,7/8,9,10,11,12,13,14,15 --output 7-8.pdb
+////         [--threads N] [--checkpoint DIR] [--checkpoint-every LEVELS] [--quiet]
+////         [--compress mod3|min:GROUP [--from EXISTING.pdb]]
+//// with --compress the output is compressed; --from compresses an existing database instead of building one
+int main(int argc, char** argv) {
+    int width = 4;
+    std::string partition, output, checkpoint_directory, compression, source;
+    unsigned threads = std::thread::hardware_concurrency();
+    int checkpoint_interval = 1;
+    bool verbose = true;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool has_value = i + 1 < argc;
+        if (arg == "--width" && has_value) width = std::stoi(argv[++i]);
+        else if (arg == "--partition" && has_value) partition = argv[++i];
+        else if (arg == "--output" && has_value) output = argv[++i];
+        else if (arg == "--threads" && has_value) threads = static_cast<unsigned>(std::stoi(argv[++i]));
+        else if (arg == "--checkpoint" && has_value) checkpoint_directory = argv[++i];
+        else if (arg == "--checkpoint-every" && has_value) checkpoint_interval = std::stoi(argv[++i]);
+        else if (arg == "--compress" && has_value) compression = argv[++i];
+        else if (arg == "--from" && has_value) source = argv[++i];
+        else if (arg == "--quiet") verbose = false;
+        else {
+            std::cerr << "unknown argument " << arg << std::endl;
+            return 2;
+        }
+    }
+    if ((partition.empty() && source.empty()) || output.empty() || (!source.empty() && compression.empty())) {
+        std::cerr << "usage: " << argv[0] << " --width N --partition 1,2,3/4,5,6 --output FILE"
+                  << " [--threads N] [--checkpoint DIR] [--checkpoint-every LEVELS] [--quiet]"
+                  << " [--compress mod3|min:GROUP [--from EXISTING]]" << std::endl;
+        return 2;
+    }
+
+    try {
+        if (source.empty()) {
+            source = compression.empty() ? output : output + ".exact";
+            PatternDatabaseBuilder builder(width, threads, checkpoint_directory, checkpoint_interval);
+            builder.set_verbose(verbose);
+            builder.build(PatternDatabase::parse_partition(partition), source);
+        }
+        if (compression == "mod3") {
+            PatternDatabaseBuilder::compress(source, output, PatternDatabase::modulo_three, 1);
+        } else if (compression.rfind("min:", 0) == 0) {
+            PatternDatabaseBuilder::compress(source, output, PatternDatabase::exact, std::stoi(compression.substr(4)));
+        } else if (!compression.empty()) {
+            throw std::invalid_argument("unknown compression " + compression);
+        }
+        PatternDatabase database(output);
+        std::cout << database.get_patterns().size() << " patterns written to " << output
+                  << " (" << database.size_in_bytes() << " bytes)" << std::endl;
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+# Batch round trip through every input and output format: the same boards as
+# whitespace separated text, as compact hex and as binary records (written by
+# instance_gen) have to give the same results, and --binary-output has to
+# carry the lengths the text output shows.
+#   cmake -DWSI1=<binary> -DINSTANCE_GEN=<binary> -DSOURCE=<tests dir> -P round_trip.cmake
+
+# the text results without the seconds column
+function(solve output)
+    execute_process(COMMAND ${WSI1} ${ARGN} RESULT_VARIABLE status OUTPUT_VARIABLE records ERROR_VARIABLE errors)
+    if (NOT status EQUAL 0)
+        message(FATAL_ERROR "wsi1 ${ARGN} exited with ${status}: ${errors}")
+    endif ()
+    string(REGEX REPLACE " [^ \n]+\n" "\n" records "${records}")
+    set(${output} "${records}" PARENT_SCOPE)
+endfunction()
+
+function(expect_same first second what)
+    if (NOT "${first}" STREQUAL "${second}")
+        message(FATAL_ERROR "${what} differ:\n${first}\n---\n${second}")
+    endif ()
+endfunction()
+
+solve(decimal --input ${SOURCE}/round_trip.txt)
+solve(hex --input ${SOURCE}/round_trip_hex.txt)
+expect_same("${decimal}" "${hex}" "decimal and hex results")
+if (decimal MATCHES "(^|\n)[0-9]+ -1 ")
+    message(FATAL_ERROR "unsolved board:\n${decimal}")
+endif ()
+
+foreach (width 2 3)
+    execute_process(COMMAND ${INSTANCE_GEN} --width ${width} --count 8 --seed 7 --output text_${width}.txt ERROR_QUIET)
+    execute_process(COMMAND ${INSTANCE_GEN} --width ${width} --count 8 --seed 7 --binary --output binary_${width}.bin ERROR_QUIET)
+    solve(text --input text_${width}.txt)
+    solve(binary --binary-input --input binary_${width}.bin)
+    expect_same("${text}" "${binary}" "${width}x${width} text and binary input results")
+endforeach ()
+
+#### --binary-output: u32 id, i16 length, u64 nodes, f64 seconds, ceil(length / 4) move bytes
+solve(unused --input ${SOURCE}/round_trip.txt --binary-output --output binary_results.bin)
+file(READ binary_results.bin bytes HEX)
+string(LENGTH "${bytes}" size)
+set(position 0)
+set(lengths "")
+while (position LESS size)
+    math(EXPR at "${position} + 8")
+    string(SUBSTRING "${bytes}" ${at} 4 field)
+    string(SUBSTRING "${field}" 2 2 high)
+    string(SUBSTRING "${field}" 0 2 low)
+    math(EXPR length "0x${high}${low}")
+    list(APPEND lengths ${length})
+    math(EXPR position "${position} + 2 * (4 + 2 + 8 + 8 + (${length} + 3) / 4)")
+endwhile ()
+string(REGEX MATCHALL "\n[0-9]+ [0-9]+" text_lengths "\n${decimal}")
+string(REGEX REPLACE "\n[0-9]+ " "" text_lengths "${text_lengths}")
+expect_same("${text_lengths}" "${lengths}" "text and binary output lengths")
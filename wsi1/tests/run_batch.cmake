@@ -0,0 +1,24 @@
+# Runs wsi1 in batch mode on INPUT with the ;-separated ARGS and checks the
+# text results: exit code 0, one record per instance, every record solved
+# (length >= 0) with as many moves as its length.
+#   cmake -DWSI1=<binary> -DINPUT=<file> -DARGS=<args> -DCOUNT=<instances> -P run_batch.cmake
+execute_process(COMMAND ${WSI1} --input ${INPUT} ${ARGS}
+                RESULT_VARIABLE status OUTPUT_VARIABLE output ERROR_VARIABLE errors)
+if (NOT status EQUAL 0)
+    message(FATAL_ERROR "wsi1 exited with ${status}: ${errors}")
+endif ()
+string(REGEX REPLACE "\n$" "" output "${output}")
+string(REPLACE "\n" ";" records "${output}")
+list(LENGTH records found)
+if (NOT found EQUAL COUNT)
+    message(FATAL_ERROR "expected ${COUNT} records, got ${found}:\n${output}")
+endif ()
+foreach (record IN LISTS records)
+    if (NOT record MATCHES "^[0-9]+ ([0-9]+) ([UDLR]*) ")
+        message(FATAL_ERROR "unsolved or malformed record: ${record}")
+    endif ()
+    string(LENGTH "${CMAKE_MATCH_2}" moves)
+    if (NOT moves EQUAL CMAKE_MATCH_1)
+        message(FATAL_ERROR "length ${CMAKE_MATCH_1} but ${moves} moves: ${record}")
+    endif ()
+endforeach ()